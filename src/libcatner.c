@@ -1,43 +1,250 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <zlib.h>
 #include <libxml/parser.h>
+#include <libxml/xmlreader.h>
+#include <libxml/xmlwriter.h>
 #include "libcatner.h"
 
+/*
+ * Per-article bookkeeping, hung off the `_private` slot of ARTICLE nodes. 
+ * It is created on first use and has to be freed before the node is freed.
+ */
+struct libcatner_article
+{
+	xmlHashTablePtr fids;	// Maps FID to FEATURE nodes, NULL until first needed
+	size_t num_features;	// Number of FEATURE nodes, valid if `fids` is set
+
+	xmlNodePtr details;	// ARTICLE_DETAILS, NULL until first found
+	xmlNodePtr features;	// ARTICLE_FEATURES, NULL until first found
+	xmlNodePtr images;	// MIME_INFO, NULL until first found
+	xmlNodePtr units;	// ARTICLE_ORDER_DETAILS, NULL until first found
+};
+
+typedef struct libcatner_article libcatner_article_s;
+
+/*
+ * Per-feature bookkeeping, hung off the `_private` slot of FEATURE nodes. 
+ * It is created on first use and has to be freed before the node is freed.
+ */
+struct libcatner_feature
+{
+	xmlHashTablePtr vids;	// Maps VID to VARIANT nodes, NULL until first needed
+	size_t num_variants;	// Number of VARIANT nodes, valid if `vids` is set
+};
+
+typedef struct libcatner_feature libcatner_feature_s;
+
+/*
+ * Identifiers of all BMEcat elements libcatner deals with. The element names 
+ * are interned in the document's dictionary on init/load, see 
+ * libcatner_intern_names(), so that libxml's node names can be matched 
+ * against them by simple pointer comparison.
+ */
+enum libcatner_name
+{
+	LIBCATNER_NAME_ROOT,
+	LIBCATNER_NAME_HEADER,
+	LIBCATNER_NAME_CATALOG,
+	LIBCATNER_NAME_LOCALE,
+	LIBCATNER_NAME_TERRITORY,
+	LIBCATNER_NAME_GENERATOR,
+	LIBCATNER_NAME_ARTICLES,
+	LIBCATNER_NAME_ARTICLE,
+	LIBCATNER_NAME_ARTICLE_ID,
+	LIBCATNER_NAME_ARTICLE_DETAILS,
+	LIBCATNER_NAME_ARTICLE_TITLE,
+	LIBCATNER_NAME_ARTICLE_DESCR,
+	LIBCATNER_NAME_ARTICLE_UNITS,
+	LIBCATNER_NAME_ARTICLE_MAIN_UNIT,
+	LIBCATNER_NAME_ARTICLE_ALT_UNIT,
+	LIBCATNER_NAME_ARTICLE_UNIT_CODE,
+	LIBCATNER_NAME_ARTICLE_UNIT_FACTOR,
+	LIBCATNER_NAME_ARTICLE_CATEGORY,
+	LIBCATNER_NAME_ARTICLE_CATEGORY_ID,
+	LIBCATNER_NAME_ARTICLE_IMAGES,
+	LIBCATNER_NAME_ARTICLE_IMAGE,
+	LIBCATNER_NAME_ARTICLE_IMAGE_MIME,
+	LIBCATNER_NAME_ARTICLE_IMAGE_PATH,
+	LIBCATNER_NAME_FEATURES,
+	LIBCATNER_NAME_FEATURE,
+	LIBCATNER_NAME_FEATURE_ID,
+	LIBCATNER_NAME_FEATURE_NAME,
+	LIBCATNER_NAME_FEATURE_ORDER,
+	LIBCATNER_NAME_FEATURE_DESCR,
+	LIBCATNER_NAME_FEATURE_UNIT,
+	LIBCATNER_NAME_FEATURE_VALUE,
+	LIBCATNER_NAME_VARIANTS,
+	LIBCATNER_NAME_VARIANT,
+	LIBCATNER_NAME_VARIANT_ID,
+	LIBCATNER_NAME_VARIANT_VALUE,
+	LIBCATNER_NUM_NAMES
+};
+
+static const xmlChar *libcatner_names[LIBCATNER_NUM_NAMES] =
+{
+	[LIBCATNER_NAME_ROOT]                = BMECAT_NODE_ROOT,
+	[LIBCATNER_NAME_HEADER]              = BMECAT_NODE_HEADER,
+	[LIBCATNER_NAME_CATALOG]             = BMECAT_NODE_CATALOG,
+	[LIBCATNER_NAME_LOCALE]              = BMECAT_NODE_LOCALE,
+	[LIBCATNER_NAME_TERRITORY]           = BMECAT_NODE_TERRITORY,
+	[LIBCATNER_NAME_GENERATOR]           = BMECAT_NODE_GENERATOR,
+	[LIBCATNER_NAME_ARTICLES]            = BMECAT_NODE_ARTICLES,
+	[LIBCATNER_NAME_ARTICLE]             = BMECAT_NODE_ARTICLE,
+	[LIBCATNER_NAME_ARTICLE_ID]          = BMECAT_NODE_ARTICLE_ID,
+	[LIBCATNER_NAME_ARTICLE_DETAILS]     = BMECAT_NODE_ARTICLE_DETAILS,
+	[LIBCATNER_NAME_ARTICLE_TITLE]       = BMECAT_NODE_ARTICLE_TITLE,
+	[LIBCATNER_NAME_ARTICLE_DESCR]       = BMECAT_NODE_ARTICLE_DESCR,
+	[LIBCATNER_NAME_ARTICLE_UNITS]       = BMECAT_NODE_ARTICLE_UNITS,
+	[LIBCATNER_NAME_ARTICLE_MAIN_UNIT]   = BMECAT_NODE_ARTICLE_MAIN_UNIT,
+	[LIBCATNER_NAME_ARTICLE_ALT_UNIT]    = BMECAT_NODE_ARTICLE_ALT_UNIT,
+	[LIBCATNER_NAME_ARTICLE_UNIT_CODE]   = BMECAT_NODE_ARTICLE_UNIT_CODE,
+	[LIBCATNER_NAME_ARTICLE_UNIT_FACTOR] = BMECAT_NODE_ARTICLE_UNIT_FACTOR,
+	[LIBCATNER_NAME_ARTICLE_CATEGORY]    = BMECAT_NODE_ARTICLE_CATEGORY,
+	[LIBCATNER_NAME_ARTICLE_CATEGORY_ID] = BMECAT_NODE_ARTICLE_CATEGORY_ID,
+	[LIBCATNER_NAME_ARTICLE_IMAGES]      = BMECAT_NODE_ARTICLE_IMAGES,
+	[LIBCATNER_NAME_ARTICLE_IMAGE]       = BMECAT_NODE_ARTICLE_IMAGE,
+	[LIBCATNER_NAME_ARTICLE_IMAGE_MIME]  = BMECAT_NODE_ARTICLE_IMAGE_MIME,
+	[LIBCATNER_NAME_ARTICLE_IMAGE_PATH]  = BMECAT_NODE_ARTICLE_IMAGE_PATH,
+	[LIBCATNER_NAME_FEATURES]            = BMECAT_NODE_FEATURES,
+	[LIBCATNER_NAME_FEATURE]             = BMECAT_NODE_FEATURE,
+	[LIBCATNER_NAME_FEATURE_ID]          = BMECAT_NODE_FEATURE_ID,
+	[LIBCATNER_NAME_FEATURE_NAME]        = BMECAT_NODE_FEATURE_NAME,
+	[LIBCATNER_NAME_FEATURE_ORDER]       = BMECAT_NODE_FEATURE_ORDER,
+	[LIBCATNER_NAME_FEATURE_DESCR]       = BMECAT_NODE_FEATURE_DESCR,
+	[LIBCATNER_NAME_FEATURE_UNIT]        = BMECAT_NODE_FEATURE_UNIT,
+	[LIBCATNER_NAME_FEATURE_VALUE]       = BMECAT_NODE_FEATURE_VALUE,
+	[LIBCATNER_NAME_VARIANTS]            = BMECAT_NODE_VARIANTS,
+	[LIBCATNER_NAME_VARIANT]             = BMECAT_NODE_VARIANT,
+	[LIBCATNER_NAME_VARIANT_ID]          = BMECAT_NODE_VARIANT_ID,
+	[LIBCATNER_NAME_VARIANT_VALUE]       = BMECAT_NODE_VARIANT_VALUE,
+};
+
+/*
+ * Returns the interned name of the BMEcat element with the given identifier.
+ * This requires the node's document to be owned by a libcatner state.
+ */
+static inline const xmlChar *libcatner_name(const xmlNodePtr node, int name)
+{
+	return ((catner_state_s *) node->doc->_private)->_names[name];
+}
+
+/*
+ * Marks the state the given node's document belongs to as modified.
+ */
+static inline void libcatner_touch(const xmlNodePtr node)
+{
+	((catner_state_s *) node->doc->_private)->_dirty = 1;
+}
+
 /*
  * Add a node with the given `name` to the given parent node. If `value` is 
  * given, a text node will be created, otherwise a regular node. 
  * Returns a reference to the newly created node. 
  */
-static inline xmlNodePtr libcatner_add_child(const xmlNodePtr parent, const xmlChar *name, 
+static inline xmlNodePtr libcatner_add_child(const xmlNodePtr parent, int name, 
 		const xmlChar *value)
 {
+	libcatner_touch(parent);
+
 	// Create empty (non-text) or text node, depending on value
-	return value == NULL ? xmlNewChild(parent, NULL, name, NULL) :
-		xmlNewTextChild(parent, NULL, name, value);
+	return value == NULL ? 
+		xmlNewChild(parent, NULL, libcatner_name(parent, name), NULL) :
+		xmlNewTextChild(parent, NULL, libcatner_name(parent, name), value);
+}
+
+/*
+ * Returns the text content of the given node without copying it, which works 
+ * if the content is held by a single text or CDATA child node. That is the 
+ * case for all nodes created by libcatner and for almost all parsed ones. 
+ * Nodes without any children yield the empty string. If the content is split 
+ * across several nodes (mixed content, comments, entities), NULL is returned 
+ * and the caller has to resort to xmlNodeGetContent().
+ */
+static const xmlChar *libcatner_get_text(const xmlNodePtr node)
+{
+	xmlNodePtr text = node->children;
+
+	// No children, no content
+	if (text == NULL)
+	{
+		return BAD_CAST "";
+	}
+
+	// Content is spread across several child nodes
+	if (text->next != NULL)
+	{
+		return NULL;
+	}
+
+	if (text->type != XML_TEXT_NODE && text->type != XML_CDATA_SECTION_NODE)
+	{
+		return NULL;
+	}
+
+	return text->content ? text->content : BAD_CAST "";
 }
 
+/*
+ * Returns 1 if the text content of the given node matches `value`, else 0.
+ */
 static int libcatner_cmp_content(const xmlNodePtr node, const xmlChar *value)
 {
+	// Compare in place if we can, which saves us a copy of the content
+	const xmlChar *text = libcatner_get_text(node);
+	if (text != NULL)
+	{
+		return xmlStrcmp(text, value) == 0;
+	}
+
 	xmlChar *content = xmlNodeGetContent(node);
 	int matches = (xmlStrcmp(content, value) == 0);
 	xmlFree(content);
 	return matches;
 }
 
+/*
+ * Sets the text content of the given node to `value`, unless it already has 
+ * that content, so that only actual changes mark the document as modified.
+ */
+static void libcatner_set_content(const xmlNodePtr node, const xmlChar *value)
+{
+	if (libcatner_cmp_content(node, value ? value : BAD_CAST ""))
+	{
+		return;
+	}
+
+	xmlNodeSetContent(node, value);
+	libcatner_touch(node);
+}
+
 /*
  * Searches the parent node for the first child that matches the given `name` 
  * and, if given, text content `value`. Returns the child node found or NULL.
  * If `create` is `1`, the child node will be created if it wasn't found.
  */
-static xmlNodePtr libcatner_get_child(const xmlNodePtr parent, const xmlChar *name, 
+static xmlNodePtr libcatner_get_child(const xmlNodePtr parent, int name, 
 		const xmlChar *value, int add)
 {
+	// Names are interned, so comparing the pointers is enough
+	const xmlChar *iname = libcatner_name(parent, name);
+
 	// Iterate all child nodes of parent
 	xmlNodePtr child = NULL;
 	for (child = parent->children; child; child = child->next)
 	{
 		// Node name mismatch, therefore we continue
-		if (xmlStrcmp(child->name, name) != 0)
+		if (child->name != iname)
 		{
 			continue;
 		}
@@ -64,7 +271,7 @@ static xmlNodePtr libcatner_get_child(const xmlNodePtr parent, const xmlChar *na
  * the given value, if such a node can be found, otherwise nothing is done.
  * Returns 0 on success, -1 if no suitable child node was found.
  */
-static int libcatner_set_child(const xmlNodePtr parent, const xmlChar *name, 
+static int libcatner_set_child(const xmlNodePtr parent, int name, 
 		const xmlChar *value, int add)
 {
 	xmlNodePtr child = libcatner_get_child(parent, name, NULL, 0);
@@ -81,7 +288,7 @@ static int libcatner_set_child(const xmlNodePtr parent, const xmlChar *name,
 		return -1;
 	}
 
-	xmlNodeSetContent(child, BAD_CAST value);
+	libcatner_set_content(child, value);
 	return 0;
 }
 
@@ -95,6 +302,7 @@ static inline int libcatner_del_node(const xmlNodePtr node)
 		return -1;
 	}
 
+	libcatner_touch(node);
 	xmlUnlinkNode(node);
 	xmlFreeNode(node);
 	return 0;
@@ -102,14 +310,15 @@ static inline int libcatner_del_node(const xmlNodePtr node)
 
 /*
  * Find and return the next sibling node of the same name and return it. 
- * If no further sibling node of the same type exists, NULL is returned.
+ * If no further sibling node of the same type exists, NULL is returned. 
+ * As element names are interned, they can be compared by pointer.
  */
 static xmlNodePtr libcatner_next_node(const xmlNodePtr node)
 {
 	xmlNodePtr current = NULL;
 	for (current = node->next; current; current = current->next)
 	{
-		if (xmlStrcmp(node->name, current->name) == 0)
+		if (current->name == node->name)
 		{
 			return current;
 		}
@@ -117,7 +326,7 @@ static xmlNodePtr libcatner_next_node(const xmlNodePtr node)
 	return NULL;
 }
 
-static int libcatner_has_child(const xmlNodePtr parent, const xmlChar *name, int empty_ok)
+static int libcatner_has_child(const xmlNodePtr parent, int name, int empty_ok)
 {
 	xmlNodePtr child = libcatner_get_child(parent, name, NULL, 0);
 
@@ -133,6 +342,12 @@ static int libcatner_has_child(const xmlNodePtr parent, const xmlChar *name, int
 	}
 
 	// Otherwise, check the content for being empty / empty string
+	const xmlChar *text = libcatner_get_text(child);
+	if (text != NULL)
+	{
+		return text[0] != '\0';
+	}
+
 	xmlChar *str = xmlNodeGetContent(child);
 
 	if (str == NULL)
@@ -141,13 +356,10 @@ static int libcatner_has_child(const xmlNodePtr parent, const xmlChar *name, int
 		return 0;
 	}
 
-	if (xmlStrlen(str) == 0)
-	{
-		// Node only holds an empty string
-		return 0;
-	}
-
-	return 1;
+	// Node might only hold an empty string
+	int len = xmlStrlen(str);
+	xmlFree(str);
+	return len > 0;
 }
 
 /*
@@ -155,17 +367,20 @@ static int libcatner_has_child(const xmlNodePtr parent, const xmlChar *name, int
  * return the number of matching nodes found. If value is given (not NULL), 
  * only child nodes with matching text content will be counted.
  */
-static size_t libcatner_num_children(const xmlNodePtr parent, const xmlChar *name, 
+static size_t libcatner_num_children(const xmlNodePtr parent, int name, 
 		const xmlChar *value)
 {
 	size_t num = 0;
 
+	// Names are interned, so comparing the pointers is enough
+	const xmlChar *iname = libcatner_name(parent, name);
+
 	// Iterate all child nodes of parent
 	xmlNodePtr child = NULL; 
 	for (child = parent->children; child; child = child->next)
 	{
 		// Node name mismatch, therefore we continue
-		if (xmlStrcmp(child->name, name) != 0)
+		if (child->name != iname)
 		{
 			continue;
 		}
@@ -221,16 +436,55 @@ static xmlNodePtr libcatner_get_child_at(const xmlNodePtr parent, const xmlChar
 }
 */
 
+/*
+ * Interns the names of all BMEcat elements in the dictionary of the state's 
+ * document, creating the dictionary if the document doesn't have one yet, 
+ * and makes the document point back to the state. Nodes created or parsed 
+ * with that dictionary share the very same name strings, which allows for 
+ * matching names by pointer, see libcatner_name(). Returns 0 on success, 
+ * -1 if out of memory.
+ */
+static int libcatner_intern_names(catner_state_s *cs)
+{
+	if (cs->doc->dict == NULL)
+	{
+		cs->doc->dict = xmlDictCreate();
+		if (cs->doc->dict == NULL)
+		{
+			return -1;
+		}
+	}
+
+	cs->_names = malloc(LIBCATNER_NUM_NAMES * sizeof(xmlChar *));
+	if (cs->_names == NULL)
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < LIBCATNER_NUM_NAMES; ++i)
+	{
+		cs->_names[i] = xmlDictLookup(cs->doc->dict, libcatner_names[i], -1);
+		if (cs->_names[i] == NULL)
+		{
+			return -1;
+		}
+	}
+
+	cs->doc->_private = cs;
+	return 0;
+}
+
 /*
  * Add the BMEcat root node to the given document and return it.
  * This function does not check for exisiting root elements.
  */
 static xmlNodePtr libcatner_add_root(const xmlDocPtr doc)
 {
-	xmlNodePtr root = xmlNewNode(NULL, BMECAT_NODE_ROOT);
+	xmlNodePtr root = xmlNewDocNode(doc, NULL, BMECAT_NODE_ROOT, NULL);
 	xmlNewProp(root, BAD_CAST "version", BMECAT_VERSION);
 	xmlNewProp(root, BAD_CAST "xmlns",   BMECAT_NAMESPACE);
 	xmlDocSetRootElement(doc, root);
+	libcatner_touch(root);
 
 	return root;
 }
@@ -267,7 +521,7 @@ static xmlNodePtr libcatner_get_root(const xmlDocPtr doc, int create)
  */
 static inline xmlNodePtr libcatner_get_header(const xmlNodePtr root, int create)
 {
-	return libcatner_get_child(root, BMECAT_NODE_HEADER, NULL, create);
+	return libcatner_get_child(root, LIBCATNER_NAME_HEADER, NULL, create);
 }
 
 /*
@@ -276,7 +530,7 @@ static inline xmlNodePtr libcatner_get_header(const xmlNodePtr root, int create)
  */
 static inline xmlNodePtr libcatner_get_articles(const xmlNodePtr root, int create)
 {
-	return libcatner_get_child(root, BMECAT_NODE_ARTICLES, NULL, create);
+	return libcatner_get_child(root, LIBCATNER_NAME_ARTICLES, NULL, create);
 }
 
 /*
@@ -285,7 +539,7 @@ static inline xmlNodePtr libcatner_get_articles(const xmlNodePtr root, int creat
  */
 static inline xmlNodePtr libcatner_get_catalog(xmlNodePtr header, int create)
 {
-	return libcatner_get_child(header, BMECAT_NODE_CATALOG, NULL, create);
+	return libcatner_get_child(header, LIBCATNER_NAME_CATALOG, NULL, create);
 }
 
 /*
@@ -294,1863 +548,5424 @@ static inline xmlNodePtr libcatner_get_catalog(xmlNodePtr header, int create)
  */
 static inline xmlNodePtr libcatner_get_generator(xmlNodePtr header, int create)
 {
-	return libcatner_get_child(header, BMECAT_NODE_GENERATOR, BAD_CAST "", create);
+	return libcatner_get_child(header, LIBCATNER_NAME_GENERATOR, BAD_CAST "", create);
 }
 
 /*
- * Given the T_NEW_CATALOG parent node, searches all ARTICLE child nodes for 
- * one that has a matching article ID (SUPPLIER_ID) and returns it. If no 
- * matching article node could be found, NULL will be returned.
+ * Adds `node` to the given index, using the content of its child node named 
+ * `id_name` as key. Nodes without such a child are ignored. If another node 
+ * with the same key is already indexed, that one is kept. Returns 0 on 
+ * success, -1 if the node could not be indexed.
  */
-static xmlNodePtr libcatner_get_article(const xmlNodePtr articles, const xmlChar *aid)
+static int libcatner_index_node(xmlHashTablePtr index, xmlNodePtr node, 
+		int id_name)
 {
-	// Iterate all articles
-	xmlNodePtr article = NULL;
-	for (article = articles->children; article; article = article->next)
+	xmlNodePtr id = libcatner_get_child(node, id_name, NULL, 0);
+	if (id == NULL)
 	{
-		// Find the article's SUPPLIER_AID element with the given aid value
-		if (libcatner_get_child(article, BMECAT_NODE_ARTICLE_ID, aid, 0))
-		{
-			// If found, return this article
-			return article;
-		}
+		return -1;
 	}
 
-	// No matching article found
-	return NULL;
+	// Only copy the content if we can't use it in place
+	const xmlChar *key = libcatner_get_text(id);
+	xmlChar *copy = key ? NULL : xmlNodeGetContent(id);
+	if (key == NULL && (key = copy) == NULL)
+	{
+		return -1;
+	}
+
+	// The table makes its own copy of the key
+	int res = xmlHashAddEntry(index, key, node);
+	xmlFree(copy);
+	return res;
 }
 
 /*
- * Given an ARTICLE node, finds and returns the FEATURE node with the given FID 
- * or NULL if no matching feature exists within the article.
+ * Removes `node` from the given index, using the content of its child node 
+ * named `id_name` as key. The entry is only removed if it actually refers to 
+ * the given node, as the key might be in use by another node as well.
  */
-static xmlNodePtr libcatner_get_feature(const xmlNodePtr article, const xmlChar *fid)
+static void libcatner_unindex_node(xmlHashTablePtr index, xmlNodePtr node, 
+		int id_name)
 {
-	// Find the ARTICLE_FEATURES node, which holds all features
-	xmlNodePtr features = libcatner_get_child(article, BMECAT_NODE_FEATURES, NULL, 0);
+	xmlNodePtr id = libcatner_get_child(node, id_name, NULL, 0);
+	if (id == NULL)
+	{
+		return;
+	}
 
-	// If ARTICLE_FEATURES doesn't exist, then no FEATUREs can exist
-	if (features == NULL)
+	// Only copy the content if we can't use it in place
+	const xmlChar *key = libcatner_get_text(id);
+	xmlChar *copy = key ? NULL : xmlNodeGetContent(id);
+	if (key == NULL && (key = copy) == NULL)
 	{
-		return NULL;
+		return;
 	}
 
-	xmlNodePtr child = NULL;
-	for (child = features->children; child; child = child->next)
+	if (xmlHashLookup(index, key) == node)
 	{
-		// We are only interested in FEATURE nodes
-		if (xmlStrcmp(child->name, BMECAT_NODE_FEATURE) != 0)
-		{
-			continue;
-		}
-		
-		// If this FEATURE has a FID and its content matches fid, we're done
-		if (libcatner_get_child(child, BMECAT_NODE_FEATURE_ID, fid, 0))
-		{
-			return child;
-		}
+		xmlHashRemoveEntry(index, key, NULL);
 	}
+	xmlFree(copy);
+}
 
-	// No matching node found
-	return NULL;
+/*
+ * Adds the given ARTICLE node to the AID index, see libcatner_index_node().
+ */
+static inline int libcatner_index_article(catner_state_s *cs, xmlNodePtr article)
+{
+	return libcatner_index_node(cs->_aid_index, article, LIBCATNER_NAME_ARTICLE_ID);
 }
 
-static xmlNodePtr libcatner_get_variant(const xmlNodePtr feature, const xmlChar *vid)
+/*
+ * Removes the given ARTICLE node from the AID index.
+ */
+static inline void libcatner_unindex_article(catner_state_s *cs, xmlNodePtr article)
 {
-	// Find the VARIANTS node, which holds all variants
-	xmlNodePtr variants = libcatner_get_child(feature, BMECAT_NODE_VARIANTS, NULL, 0);
+	libcatner_unindex_node(cs->_aid_index, article, LIBCATNER_NAME_ARTICLE_ID);
+}
 
-	// If VARIANTS doesn't exist, then no variants can exists
-	if (variants == NULL)
+/*
+ * Creates the AID index and adds all ARTICLE nodes found in T_NEW_CATALOG.
+ * Returns 0 on success, -1 if the index could not be created.
+ */
+static int libcatner_build_aid_index(catner_state_s *cs)
+{
+	cs->_aid_index = xmlHashCreate(0);
+	if (cs->_aid_index == NULL)
 	{
-		return NULL;
+		return -1;
 	}
 
-	xmlNodePtr child = NULL;
-	for (child = variants->children; child; child = child->next)
+	xmlNodePtr article = libcatner_get_child(cs->articles, LIBCATNER_NAME_ARTICLE, NULL, 0);
+	for (; article; article = libcatner_next_node(article))
 	{
-		// We are only interested in VARIANT nodes
-		if (xmlStrcmp(child->name, BMECAT_NODE_VARIANT) != 0)
-		{
-			continue;
-		}
-
-		// If this VARIANT has a SUPPLIED_AID_SUPPLEMENT and its content matches VID, we're done
-		if (libcatner_get_child(child, BMECAT_NODE_VARIANT_ID, vid, 0))
-		{
-			return child;
-		}
+		libcatner_index_article(cs, article);
+		++cs->_num_articles;
 	}
+	return 0;
+}
 
-	// No matching node found
-	return NULL;
+/*
+ * Returns the ARTICLE node that has a matching article ID (SUPPLIER_AID),
+ * as found in the state's AID index. If no matching article node could be
+ * found, NULL will be returned.
+ */
+static xmlNodePtr libcatner_get_article(catner_state_s *cs, const xmlChar *aid)
+{
+	return xmlHashLookup(cs->_aid_index, aid);
 }
 
 /*
- * Extract the content from the given node and copy it into the given buffer. 
- * If the buffer isn't big enough to hold the content, truncation will happen. 
- * Returns the number of bytes (including the terminating null-byte), that was 
- * or would've been required to copy the entire content, or 0 on error.
+ * Returns the bookkeeping struct of the given ARTICLE node, creating it if it 
+ * doesn't exist yet. Returns NULL if out of memory.
  */
-static size_t libcatner_cpy_content(xmlNodePtr node, char *buf, size_t len)
+static libcatner_article_s *libcatner_get_article_meta(xmlNodePtr article)
 {
-	// Return 0 (error) if node is NULL 
-	if (node == NULL)
+	if (article->_private == NULL)
 	{
-		//buf[0] = '\0';
-		return 0;
+		article->_private = calloc(1, sizeof(libcatner_article_s));
 	}
+	return article->_private;
+}
 
-	// Fetch the content string
-	xmlChar *content = xmlNodeGetContent(node);
-	
-	// Return 0 (error) if node has no content
-	if (content == NULL)
+/*
+ * Returns the bookkeeping struct of the given FEATURE node, creating it if it 
+ * doesn't exist yet. Returns NULL if out of memory.
+ */
+static libcatner_feature_s *libcatner_get_feature_meta(xmlNodePtr feature)
+{
+	if (feature->_private == NULL)
 	{
-		//buf[0] = '\0';
-		return 0;
+		feature->_private = calloc(1, sizeof(libcatner_feature_s));
 	}
+	return feature->_private;
+}
 
-	// Figure out the length of the string (add one for 0-terminator)
-	int content_len = xmlStrlen(content) + 1;
-
-	// Figure out the max length we can copy
-	size_t copy_len = content_len > len ? len : content_len;
-
-	// Only perform the actual copying if buf isn't NULL
-	if (buf)
+/*
+ * Frees the bookkeeping struct of the given FEATURE node, if it has one.
+ */
+static void libcatner_free_feature_meta(xmlNodePtr feature)
+{
+	libcatner_feature_s *meta = feature->_private;
+	if (meta == NULL)
 	{
-		// Copy everything over (that fits in the buffer)
-		strncpy(buf, (char *) content, copy_len);
-	
-		// Make sure the buffer is 0-terminated
-		buf[copy_len - 1] = '\0';
+		return;
 	}
 
-	// Free the content string we received from libxml
-	xmlFree(content);
-
-	// Return the buffer size that was needed to copy everything (including 
-	// the terminating null-byte) which might be more than what was used in 
-	// case the provided buffer wasn't sufficient
-	return content_len;
+	xmlHashFree(meta->vids, NULL);
+	free(meta);
+	feature->_private = NULL;
 }
 
-static size_t libcatner_num_features(xmlNodePtr article)
+/*
+ * Frees the bookkeeping struct of the given ARTICLE node, if it has one, 
+ * as well as those of all its FEATURE nodes.
+ */
+static void libcatner_free_article_meta(xmlNodePtr article)
 {
-	xmlNodePtr features = libcatner_get_child(article, BMECAT_NODE_FEATURES, NULL, 0);
-	if (features == NULL)
+	// The article's features might have bookkeeping data of their own
+	xmlNodePtr features = libcatner_get_child(article, LIBCATNER_NAME_FEATURES, NULL, 0);
+	xmlNodePtr feature = features ? 
+		libcatner_get_child(features, LIBCATNER_NAME_FEATURE, NULL, 0) : NULL;
+	for (; feature; feature = libcatner_next_node(feature))
 	{
-		return 0;
+		libcatner_free_feature_meta(feature);
 	}
 
-	return libcatner_num_children(features, BMECAT_NODE_FEATURE, NULL);
-}
-
-static size_t libcatner_num_variants(xmlNodePtr feature)
-{
-	xmlNodePtr variants = libcatner_get_child(feature, BMECAT_NODE_VARIANTS, NULL, 0);
-	if (variants == NULL)
+	libcatner_article_s *meta = article->_private;
+	if (meta == NULL)
 	{
-		return 0;
+		return;
 	}
 
-	return libcatner_num_children(variants, BMECAT_NODE_VARIANT, NULL);
+	xmlHashFree(meta->fids, NULL);
+	free(meta);
+	article->_private = NULL;
 }
 
 /*
- * TODO documentation
+ * Returns the container child node with the given name (one of ARTICLE_DETAILS,
+ * ARTICLE_FEATURES, MIME_INFO or ARTICLE_ORDER_DETAILS) of the given ARTICLE 
+ * node. The node is remembered in the article's bookkeeping struct, so only 
+ * the first call for any article and container has to search for it. If 
+ * `add` is `1`, the container will be created if it doesn't exist yet.
  */
-static int libcatner_fix_feature_order(xmlNodePtr article)
+static xmlNodePtr libcatner_get_container(xmlNodePtr article, int name, int add)
 {
-	// Find the ARTICLE_FEATUERS node containing all features
-	xmlNodePtr features = libcatner_get_child(article, BMECAT_NODE_FEATURES, NULL, 0);
-
-	// Article has no features yet
-	if (features == NULL)
+	libcatner_article_s *meta = libcatner_get_article_meta(article);
+	if (meta == NULL)
 	{
-		return -1;
+		return libcatner_get_child(article, name, NULL, add);
 	}
 
-	xmlNodePtr feature = libcatner_get_child(features, BMECAT_NODE_FEATURE, NULL, 0);
-	char order[8];
-	order[0] = '\0';
+	xmlNodePtr *container = NULL;
+	switch (name)
+	{
+		case LIBCATNER_NAME_ARTICLE_DETAILS:
+			container = &meta->details;
+			break;
+		case LIBCATNER_NAME_FEATURES:
+			container = &meta->features;
+			break;
+		case LIBCATNER_NAME_ARTICLE_IMAGES:
+			container = &meta->images;
+			break;
+		case LIBCATNER_NAME_ARTICLE_UNITS:
+			container = &meta->units;
+			break;
+		default:
+			return libcatner_get_child(article, name, NULL, add);
+	}
 
-	for (size_t i = 1; feature; feature = libcatner_next_node(feature))
+	// Containers are never removed, so a cached pointer stays valid
+	if (*container == NULL)
 	{
-		snprintf(order, 8, "%zu", i);
-		// Update the node (create it if it didn't exist yet)
-		libcatner_set_child(feature, BMECAT_NODE_FEATURE_ORDER, BAD_CAST order, 1);
-		++i;
+		*container = libcatner_get_child(article, name, NULL, add);
 	}
-	
-	return 0;
+	return *container;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-//                                                                           //
-//  PUBLIC API                                                               //
-//                                                                           //
-///////////////////////////////////////////////////////////////////////////////
-
-//
-// ADD
-//
-
 /*
- * Add the GENERATOR_INFO node and set it to the given `value`.
- * If the node already exists, it will not be changed and -1 is returned.
- * Otherwise, the node will be created and the function returns 0.
+ * Adds the given FEATURE node to the FID index of the given ARTICLE node. 
+ * If the index has not been built yet, nothing is done, as the feature will 
+ * be picked up once it is.
  */
-int catner_add_generator(catner_state_s *cs, const char *value)
+static void libcatner_index_feature(xmlNodePtr article, xmlNodePtr feature)
 {
-	if (cs->generator)
+	libcatner_article_s *meta = article->_private;
+	if (meta && meta->fids)
 	{
-		// Already exists
-		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
-		return -1;
+		libcatner_index_node(meta->fids, feature, LIBCATNER_NAME_FEATURE_ID);
 	}
-
-	libcatner_add_child(cs->header, BMECAT_NODE_GENERATOR, BAD_CAST value);
-	return 0;
 }
 
 /*
- * Add a TERRITORY with the given value.
- * Returns 0 on success, -1 on error.
- *
- * TERRITORY nodes tell the processing software (the shop) what regions the 
- * products in this BMEcat file can be shipped to. Examples: "DE", "AT".
- * There can be multiple TERRITORY nodes, but each has to have a unique value.
- *
- * TODO - should we make sure `value` is uppercase?
- *      - should we trim whitespace from `value`?
+ * Removes the given FEATURE node from the FID index of the given ARTICLE node.
  */
-int catner_add_territory(catner_state_s *cs, const char *value)
+static void libcatner_unindex_feature(xmlNodePtr article, xmlNodePtr feature)
 {
-	// Valid TERRITORY values should be two uppercase ASCII letters
-	if (xmlStrlen(BAD_CAST value) != 2)
+	libcatner_article_s *meta = article->_private;
+	if (meta && meta->fids)
 	{
-		cs->error = LIBCATNER_ERR_INVALID_VALUE;
-		return -1;
+		libcatner_unindex_node(meta->fids, feature, LIBCATNER_NAME_FEATURE_ID);
 	}
-
-	// Find or create the TERRITORY node with the given value
-	xmlNodePtr t = libcatner_get_child(cs->catalog, BMECAT_NODE_TERRITORY, BAD_CAST value, 1);
-	
-	// Couldn't find nor create the TERRITORY node, no idea why
-	if (t == NULL)
-	{
-		cs->error = LIBCATNER_ERR_OTHER;
-		return -1;
-	}
-	
-	return 0;
-}
+}
 
 /*
- * Add a new article with the given ID (SUPPLIER_AID), title and description.
- * If an article with the given ID already exists, this function returns -1.
- * Otherwise, the article will be created and the function returns 0.
- * On error (for example, aid is the empty string), -1 will be returned.
+ * Creates the FID index for the given ARTICLE node and adds all of the 
+ * article's FEATURE nodes to it, counting them along the way. Returns the 
+ * index or NULL on error.
  */
-int catner_add_article(catner_state_s *cs, const char *aid, const char *title, const char *descr)
+static xmlHashTablePtr libcatner_build_fid_index(xmlNodePtr article)
 {
-	if (xmlStrlen(BAD_CAST aid) == 0)
+	libcatner_article_s *meta = libcatner_get_article_meta(article);
+	if (meta == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		return NULL;
 	}
 
-	// Check if an article with the given AID already exists
-	if (libcatner_get_article(cs->articles, BAD_CAST aid) != NULL)
+	meta->fids = xmlHashCreate(0);
+	if (meta->fids == NULL)
 	{
-		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
-		return -1;
+		return NULL;
 	}
 
-	// Create ARTICLE node with SUPPLIER_AID and ARTICLE_DETAILS child nodes
-	xmlNodePtr article = xmlNewChild(cs->articles, NULL, BMECAT_NODE_ARTICLE, NULL);
-	xmlNewTextChild(article, NULL, BMECAT_NODE_ARTICLE_ID, BAD_CAST aid);
-	xmlNodePtr details = xmlNewChild(article, NULL, BMECAT_NODE_ARTICLE_DETAILS, NULL);
-
-	// Possibly add DESCRIPTION_SHORT child node to ARTICLE_DETAILS
-	if (title != NULL)
+	// Find the ARTICLE_FEATURES node, which holds all features
+	xmlNodePtr features = libcatner_get_container(article, LIBCATNER_NAME_FEATURES, 0);
+	if (features == NULL)
 	{
-		xmlNewTextChild(details, NULL, BMECAT_NODE_ARTICLE_TITLE, BAD_CAST title);
+		return meta->fids;
 	}
-	// Possibly add DESCRIPTION_LONG child node to ARTICLE_DETAILS
-	if (descr != NULL)
+
+	xmlNodePtr feature = libcatner_get_child(features, LIBCATNER_NAME_FEATURE, NULL, 0);
+	for (; feature; feature = libcatner_next_node(feature))
 	{
-		xmlNewTextChild(details, NULL, BMECAT_NODE_ARTICLE_DESCR, BAD_CAST descr);
+		libcatner_index_feature(article, feature);
+		++meta->num_features;
 	}
-	
-	return 0;
+	return meta->fids;
 }
 
 /*
- * TODO documentation
+ * Given an ARTICLE node, finds and returns the FEATURE node with the given FID 
+ * or NULL if no matching feature exists within the article. The article's 
+ * FID index will be built on the first call for any given article.
  */
-int catner_add_article_image(catner_state_s *cs, const char *aid, const char *mime, const char *path)
+static xmlNodePtr libcatner_get_feature(const xmlNodePtr article, const xmlChar *fid)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	libcatner_article_s *meta = article->_private;
+	xmlHashTablePtr fids = meta && meta->fids ? meta->fids : 
+		libcatner_build_fid_index(article);
 
-	if (article == NULL)
+	return xmlHashLookup(fids, fid);
+}
+
+/*
+ * Adds the given VARIANT node to the VID index of the given FEATURE node. 
+ * If the index has not been built yet, nothing is done, as the variant will 
+ * be picked up once it is.
+ */
+static void libcatner_index_variant(xmlNodePtr feature, xmlNodePtr variant)
+{
+	libcatner_feature_s *meta = feature->_private;
+	if (meta && meta->vids)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		libcatner_index_node(meta->vids, variant, LIBCATNER_NAME_VARIANT_ID);
 	}
-	
-	// Find or create the MIME_INFO (image container) node for this article
-	xmlNodePtr images = libcatner_get_child(article, BMECAT_NODE_ARTICLE_IMAGES, NULL, 1);
+}
 
-	// See if there is already an image with that path present
-	xmlNodePtr image = NULL;
-	for (image = images->children; image; image = image->next)
+/*
+ * Removes the given VARIANT node from the VID index of the given FEATURE node.
+ */
+static void libcatner_unindex_variant(xmlNodePtr feature, xmlNodePtr variant)
+{
+	libcatner_feature_s *meta = feature->_private;
+	if (meta && meta->vids)
 	{
-		// Check if this MIME node has a MIME_SOURCE node with the given `path` value
-		if (libcatner_get_child(image, BMECAT_NODE_ARTICLE_IMAGE_PATH, BAD_CAST path, 0))
-		{
-			// If so, this image already exists, we're done
-			cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
-			return -1;
-		}
+		libcatner_unindex_node(meta->vids, variant, LIBCATNER_NAME_VARIANT_ID);
 	}
-
-	// No such image present yet, let's create and return it
-	image = xmlNewChild(images, NULL, BMECAT_NODE_ARTICLE_IMAGE, NULL);
-	// TODO use xmlNewChild() or xmlNewTextChild()? 
-	xmlNewTextChild(image, NULL, BMECAT_NODE_ARTICLE_IMAGE_MIME, BAD_CAST mime);
-	xmlNewTextChild(image, NULL, BMECAT_NODE_ARTICLE_IMAGE_PATH, BAD_CAST path);
-
-	return 0;
 }
 
 /*
- * Adds a new alternative unit to the given article. If the article didn't have 
- * a main unit set before, this unit will also be set as such. If the unit code 
- * or factor aren't given, sensible defaults ("PCE" and "1") will be used. When 
- * `main` is `1`, the current main unit (if any) will be updated with this one.
- *
- * TODO - it doesn't technically make much sense to have a main unit that has 
- *        a factor other than "1" ("1.0", "1.00", ...), let's handle that
- *      - we should consider taking the factor as a double, then converting it
- *      - currently, calling this function with a unit CODE that already exists,
- *        it will override the factor for that unit; instead, it should return 
- *        -1 and set error to LIBCATNER_ERR_ALREADY_EXISTS; however, before we
- *        change this, we should write catner_set_article_unit() so that there
- *        is a way to update an existing unit...
+ * Adjusts the feature count of the given ARTICLE node by `delta`, if it has 
+ * been established yet, see libcatner_num_features().
  */
-int catner_add_article_unit(catner_state_s *cs, const char *aid, 
-		const char *code, const char *factor, int main)
+static void libcatner_count_features(xmlNodePtr article, int delta)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
-
-	if (article == NULL)
+	libcatner_article_s *meta = article->_private;
+	if (meta && meta->fids)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		meta->num_features += delta;
 	}
+}
 
-	// Construct unit factor string based on user input and default value
-	const char *c = code   ? code   : LIBCATNER_DEF_UNIT_CODE;
-	const char *f = factor ? factor : LIBCATNER_DEF_UNIT_FACTOR;
-
-	// Find the ARTICLE_ORDER_DETAILS node, which holds all units
-	xmlNodePtr details = libcatner_get_child(article, BMECAT_NODE_ARTICLE_UNITS, NULL, 1);
-
-	// Iterate ARTICLE_ORDER_DETAILS' children to find ALTERNATIVE_UNIT nodes
-	xmlNodePtr alt_unit = NULL;
-	xmlNodePtr child = details->children;
-	for (child = details->children; child; child = child->next)
+/*
+ * Adjusts the variant count of the given FEATURE node by `delta`, if it has 
+ * been established yet, see libcatner_num_variants().
+ */
+static void libcatner_count_variants(xmlNodePtr feature, int delta)
+{
+	libcatner_feature_s *meta = feature->_private;
+	if (meta && meta->vids)
 	{
-		// We're only interested in ALTERNATIVE_UNIT nodes
-		if (xmlStrcmp(child->name, BMECAT_NODE_ARTICLE_ALT_UNIT) != 0)
-		{
-			continue;
-		}
-		
-		// Check if this ALTERNATIVE_UNIT has the unit code we're looking for
-		if (libcatner_get_child(child, BMECAT_NODE_ARTICLE_UNIT_CODE, BAD_CAST c, 0))
-		{
-			// If so, remember this node and stop iterating
-			alt_unit = child;
-			break;
-		}
+		meta->num_variants += delta;
 	}
+}
 
-	xmlNodePtr main_unit = libcatner_get_child(details, BMECAT_NODE_ARTICLE_MAIN_UNIT, NULL, 0);
-
-	// No ORDER_UNIT (main unit) present yet, let's add it
-	if (main_unit == NULL)
+/*
+ * Creates the VID index for the given FEATURE node and adds all of the 
+ * feature's VARIANT nodes to it, counting them along the way. Returns the 
+ * index or NULL on error.
+ */
+static xmlHashTablePtr libcatner_build_vid_index(xmlNodePtr feature)
+{
+	libcatner_feature_s *meta = libcatner_get_feature_meta(feature);
+	if (meta == NULL)
 	{
-		main_unit = xmlNewTextChild(details, NULL, BMECAT_NODE_ARTICLE_MAIN_UNIT, BAD_CAST c);
+		return NULL;
 	}
 
-	// ORDER_UNIT (main unit) present; let's update the main unit, if so requested 
-	else if (main)
+	meta->vids = xmlHashCreate(0);
+	if (meta->vids == NULL)
 	{
-		xmlNodeSetContent(main_unit, BAD_CAST c);
+		return NULL;
 	}
 
-	// ALTERNATIVE_UNIT node wasn't present for this unit code, we'll add it now
-	if (alt_unit == NULL)
+	// Find the VARIANTS node, which holds all variants
+	xmlNodePtr variants = libcatner_get_child(feature, LIBCATNER_NAME_VARIANTS, NULL, 0);
+	if (variants == NULL)
 	{
-		alt_unit = xmlNewChild(details, NULL, BMECAT_NODE_ARTICLE_ALT_UNIT, NULL);
-		xmlNewTextChild(alt_unit, NULL, BMECAT_NODE_ARTICLE_UNIT_CODE,   BAD_CAST c);
-		xmlNewTextChild(alt_unit, NULL, BMECAT_NODE_ARTICLE_UNIT_FACTOR, BAD_CAST f);
+		return meta->vids;
 	}
-	
-	// ALTERNATIVE_UNIT was present, we'll just update it
-	else
+
+	xmlNodePtr variant = libcatner_get_child(variants, LIBCATNER_NAME_VARIANT, NULL, 0);
+	for (; variant; variant = libcatner_next_node(variant))
 	{
-		xmlNodePtr unit_factor = libcatner_get_child(alt_unit, BMECAT_NODE_ARTICLE_UNIT_FACTOR, NULL, 0);
-		xmlNodeSetContent(unit_factor, BAD_CAST f);
+		libcatner_index_variant(feature, variant);
+		++meta->num_variants;
 	}
+	return meta->vids;
+}
 
-	return 0;
+/*
+ * Given a FEATURE node, finds and returns the VARIANT node with the given VID 
+ * (SUPPLIER_AID_SUPPLEMENT) or NULL if no such variant exists. The feature's 
+ * VID index will be built on the first call for any given feature.
+ */
+static xmlNodePtr libcatner_get_variant(const xmlNodePtr feature, const xmlChar *vid)
+{
+	libcatner_feature_s *meta = feature->_private;
+	xmlHashTablePtr vids = meta && meta->vids ? meta->vids : 
+		libcatner_build_vid_index(feature);
+
+	return xmlHashLookup(vids, vid);
 }
 
 /*
- * Adds the given category ID to the article with the ID `aid` and returns 0.
- * If there is no article with the given `aid` or if the article already has 
- * the given category associated with it, this function returns -1.
+ * Extract the content from the given node and copy it into the given buffer. 
+ * If the buffer isn't big enough to hold the content, truncation will happen. 
+ * Returns the number of bytes (including the terminating null-byte), that was 
+ * or would've been required to copy the entire content, or 0 on error.
  */
-int catner_add_article_category(catner_state_s *cs, const char *aid, const char *value)
+static size_t libcatner_cpy_content(xmlNodePtr node, char *buf, size_t len)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	// Return 0 (error) if node is NULL 
+	if (node == NULL)
+	{
+		//buf[0] = '\0';
+		return 0;
+	}
 
-	if (article == NULL)
+	// Fetch the content string
+	xmlChar *content = xmlNodeGetContent(node);
+	
+	// Return 0 (error) if node has no content
+	if (content == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		//buf[0] = '\0';
+		return 0;
 	}
 
-	xmlNodePtr child = NULL;
-	for (child = article->children; child; child = child->next)
+	// Figure out the length of the string (add one for 0-terminator)
+	int content_len = xmlStrlen(content) + 1;
+
+	// Figure out the max length we can copy
+	size_t copy_len = content_len > len ? len : content_len;
+
+	// Only perform the actual copying if buf isn't NULL
+	if (buf)
 	{
-		// We are only interested in ARTICLE_REFERENCE nodes
-		if (xmlStrcmp(child->name, BMECAT_NODE_ARTICLE_CATEGORY) != 0)
-		{
-			continue;
-		}
+		// Copy everything over (that fits in the buffer)
+		strncpy(buf, (char *) content, copy_len);
 	
-		if (libcatner_get_child(child, BMECAT_NODE_ARTICLE_CATEGORY_ID, BAD_CAST value, 0))
-		{
-			// Already exists
-			cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
-			return -1;
-		}
+		// Make sure the buffer is 0-terminated
+		buf[copy_len - 1] = '\0';
 	}
 
-	// No such category present yet, let's add it
-	xmlNodePtr cat = xmlNewChild(article, NULL, BMECAT_NODE_ARTICLE_CATEGORY, NULL);
-	xmlNewTextChild(cat, NULL, BMECAT_NODE_ARTICLE_CATEGORY_ID, BAD_CAST value);
+	// Free the content string we received from libxml
+	xmlFree(content);
 
-	return 0;
+	// Return the buffer size that was needed to copy everything (including 
+	// the terminating null-byte) which might be more than what was used in 
+	// case the provided buffer wasn't sufficient
+	return content_len;
 }
 
 /*
- * TODO documentation
+ * Points `view` at the text content of the given node, without copying it. 
+ * Returns 0 on success. If there is no node, or if its content is split 
+ * across several child nodes (see libcatner_get_text()) and can therefore 
+ * only be had as a copy, `view` is emptied, the error set and -1 returned.
  */
-int catner_add_feature(catner_state_s *cs, const char *aid, const char *fid, 
-		const char *name, const char *descr, const char *unit, const char *value)
+static int libcatner_view_content(catner_state_s *cs, xmlNodePtr node, catner_str_s *view)
 {
-	// Find the ARTICLE node with the given AID
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) : 
-		cs->_curr_article;
-	
-	// Article doesn't exist, that's an error
-	if (article == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
-	}
+	const xmlChar *text = node ? libcatner_get_text(node) : NULL;
 
-	// See if a FEATURE node with the given FID already exists
-	xmlNodePtr feature = libcatner_get_feature(article, BAD_CAST fid);
-	
-	// Feature already exists, we're done
-	if (feature != NULL)
+	view->ptr = (const char *) text;
+	view->len = text ? strlen((const char *) text) : 0;
+
+	if (text == NULL)
 	{
-		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+		cs->error = node ? LIBCATNER_ERR_OTHER : LIBCATNER_ERR_NO_SUCH_NODE;
 		return -1;
 	}
-
-	// Figure out the number of existing FEATUREs and make it a string
-	size_t num_features = libcatner_num_features(article);
-	char order[8];
-	snprintf(order, 8, "%zu", num_features + 1);
-
-	xmlNodePtr features = libcatner_get_child(article, BMECAT_NODE_FEATURES, NULL, 1);
-	feature = xmlNewChild(features, NULL, BMECAT_NODE_FEATURE, NULL);
-	xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_ID, BAD_CAST fid);
-	xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_ORDER, BAD_CAST order);
-
-	if (name)
-		xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_NAME,  BAD_CAST name);
-	
-	if (descr)
-		xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_DESCR, BAD_CAST descr);
-	
-	if (unit)
-		xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_UNIT,  BAD_CAST unit);
-	
-	if (value)
-		xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_VALUE, BAD_CAST value);
-
 	return 0;
 }
 
 /*
- * TODO - add documentation
- *      - is it a problem that catner_add_feature() will add the FORDER node?
+ * Like libcatner_view_content(), but for the child node with the given name.
  */
-int catner_add_weight_feature(catner_state_s *cs, const char *aid, const char *value)
+static inline int libcatner_view_child(catner_state_s *cs, xmlNodePtr parent, int name, 
+		catner_str_s *view)
 {
-	return catner_add_feature(cs, aid, LIBCATNER_FEATURE_WEIGHT, 
-			LIBCATNER_FEATURE_WEIGHT, NULL, NULL, NULL);
+	xmlNodePtr child = parent ? libcatner_get_child(parent, name, NULL, 0) : NULL;
+	return libcatner_view_content(cs, child, view);
 }
 
 /*
- * TODO - documentation
+ * Points `view` at the text content of the given node, if any, without 
+ * copying it. Other than libcatner_view_content(), this doesn't fail, but 
+ * leaves the view empty, with `ptr` set to NULL, if there is no such text.
  */
-int catner_add_variant(catner_state_s *cs, const char *aid, 
-		const char *fid, const char *vid, const char *value)
+static void libcatner_view_text(xmlNodePtr node, catner_str_s *view)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
-	
-	// Article doesn't exist, that's an error
-	if (article == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
-	}
+	const xmlChar *text = node ? libcatner_get_text(node) : NULL;
 
-	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
-		cs->_curr_feature;
+	view->ptr = (const char *) text;
+	view->len = text ? strlen((const char *) text) : 0;
+}
 
-	// Feature doesn't exist, that's an error
-	if (feature == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
-		return -1;
-	}
+/*
+ * Joins the contents of the given node and all following siblings of the 
+ * same name into a comma-separated list in `buf`, as far as it fits into 
+ * `len` bytes. If `id_name` isn't -1, the content of the child node with 
+ * that name is used instead, nodes without it are skipped. Returns the 
+ * buffer size required to hold the entire list, including the terminator.
+ */
+static size_t libcatner_join_values(xmlNodePtr node, int id_name, char *buf, size_t len)
+{
+	size_t cur_len = 0;
+	size_t req_len = 0;
 
-	// Find or create VARIANTS node
-	xmlNodePtr variants = libcatner_get_child(feature, BMECAT_NODE_VARIANTS, NULL, 1);
-	
-	// Iterate over all VARIANT child nodes
-	xmlNodePtr child = NULL;
-	for (child = variants->children; child; child = child->next)
+	for (; node; node = libcatner_next_node(node))
 	{
-		// We are only interested in VARIANT nodes
-		if (xmlStrcmp(child->name, BMECAT_NODE_VARIANT) != 0)
+		xmlNodePtr value = id_name == -1 ? node : libcatner_get_child(node, id_name, NULL, 0);
+		if (value == NULL)
 		{
 			continue;
 		}
-	
-		// If this VARIANT has a VID and its content matches vid, we're done
-		if (libcatner_get_child(child, BMECAT_NODE_VARIANT_ID, BAD_CAST vid, 0))
+
+		// Only copy the content if we can't use it in place
+		const xmlChar *text = libcatner_get_text(value);
+		xmlChar *copy = text ? NULL : xmlNodeGetContent(value);
+		if (text == NULL && (text = copy) == NULL)
 		{
-			cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
-			return -1;
+			continue;
+		}
+
+		size_t text_len = xmlStrlen(text);
+		int comma = (req_len != 0);
+		req_len += comma + text_len;
+
+		// As req_len only grows, we stop adding at the first value that doesn't fit
+		if (buf && req_len < len)
+		{
+			if (comma)
+			{
+				buf[cur_len++] = ',';
+			}
+			memcpy(buf + cur_len, text, text_len);
+			cur_len += text_len;
 		}
+		xmlFree(copy);
 	}
 
-	// Features with variants should not have a FVALUE node themselves
-	xmlNodePtr fvalue = libcatner_get_child(feature, BMECAT_NODE_FEATURE_VALUE, NULL, 0);
-	if (fvalue)
+	if (buf && len)
 	{
-		// ... so if there is one, we'll remove it
-		libcatner_del_node(fvalue);
+		buf[cur_len] = '\0';
 	}
-	
-	// VARIANT does not yet exist, let's create it
-	xmlNodePtr variant = xmlNewChild(variants, NULL, BMECAT_NODE_VARIANT, NULL);
-	xmlNewTextChild(variant, NULL, BMECAT_NODE_VARIANT_ID,    BAD_CAST vid);
-	xmlNewTextChild(variant, NULL, BMECAT_NODE_VARIANT_VALUE, BAD_CAST value);
-
-	return 0;
-}
-
-int catner_add_weight_variant(catner_state_s *cs, const char *aid, const char *vid, const char *value)
-{
-	return catner_add_variant(cs, aid, LIBCATNER_FEATURE_WEIGHT, vid, value);
+	return req_len + 1;
 }
 
-//
-// SET
-// 
-
 /*
- * Set the LOCALE to the given value, overwriting the existing value if any.
- * If the node didn't exist yet, it will be created.
- * Returns 0 on success, -1 on error.
- *
- * The LOCALE node tells the processing software (the shop) what language the 
- * information in the file is in. Valid values are, for example, "EN" or "DE". 
- * 
- * TODO - should we make sure `value` is uppercase?
- *      - should we trim whitespace from `value`?
+ * Returns the number of FEATURE nodes of the given ARTICLE node. The count is 
+ * established along with the FID index and maintained from then on.
  */
-int catner_set_locale(catner_state_s *cs, const char *value)
+static size_t libcatner_num_features(xmlNodePtr article)
 {
-	// Valid LOCALE values should be two uppercase ASCII letters
-	if (xmlStrlen(BAD_CAST value) != 2)
+	libcatner_article_s *meta = article->_private;
+	if ((meta && meta->fids) || libcatner_build_fid_index(article))
 	{
-		cs->error = LIBCATNER_ERR_INVALID_VALUE;
-		return -1;
+		meta = article->_private;
+		return meta->num_features;
 	}
 
-	libcatner_set_child(cs->catalog, BMECAT_NODE_LOCALE, BAD_CAST value, 1);
-	return 0;
-}
-
-/*
- * Set the GENERATOR_INFO node to the given value. If the node didn't exist
- * yet, it will be created.
- *
- * This node is optional and gives information on the software that 
- * was used to generate the BMEcat file.
- */
-int catner_set_generator(catner_state_s *cs, const char *value)
-{
-	if (cs->generator == NULL)
+	// Couldn't build the index, let's count the hard way
+	xmlNodePtr features = libcatner_get_container(article, LIBCATNER_NAME_FEATURES, 0);
+	if (features == NULL)
 	{
-		cs->generator = libcatner_add_child(cs->header, BMECAT_NODE_GENERATOR, BAD_CAST value);
 		return 0;
 	}
 
-	xmlNodeSetContent(cs->generator, BAD_CAST value);
-	return 0;
+	return libcatner_num_children(features, LIBCATNER_NAME_FEATURE, NULL);
 }
 
-int catner_set_article_id(catner_state_s *cs, const char *aid, const char *value)
+/*
+ * Returns the number of VARIANT nodes of the given FEATURE node. The count is 
+ * established along with the VID index and maintained from then on.
+ */
+static size_t libcatner_num_variants(xmlNodePtr feature)
 {
-	if (xmlStrlen(BAD_CAST value) == 0)
+	libcatner_feature_s *meta = feature->_private;
+	if ((meta && meta->vids) || libcatner_build_vid_index(feature))
 	{
-		cs->error = LIBCATNER_ERR_INVALID_VALUE;
-		return -1;
+		meta = feature->_private;
+		return meta->num_variants;
 	}
 
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
-
-	if (article == NULL)
+	// Couldn't build the index, let's count the hard way
+	xmlNodePtr variants = libcatner_get_child(feature, LIBCATNER_NAME_VARIANTS, NULL, 0);
+	if (variants == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		return 0;
 	}
 
-	return libcatner_set_child(article, BMECAT_NODE_ARTICLE_ID, BAD_CAST value, 0);
+	return libcatner_num_children(variants, LIBCATNER_NAME_VARIANT, NULL);
 }
 
 /*
- * Sets the title (DESCRIPTION_SHORT) of the article with the given AID. 
- * Returns -1 if no matching article could be found, otherwise 0.
+ * TODO documentation
  */
-int catner_set_article_title(catner_state_s *cs, const char *aid, const char *value)
+static int libcatner_fix_feature_order(xmlNodePtr article)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	// Find the ARTICLE_FEATUERS node containing all features
+	xmlNodePtr features = libcatner_get_container(article, LIBCATNER_NAME_FEATURES, 0);
 
-	if (article == NULL)
+	// Article has no features yet
+	if (features == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
 		return -1;
 	}
 
-	// Find or create the ARTICLE_DETAILS node within this ARTICLE
-	xmlNodePtr details = libcatner_get_child(article, BMECAT_NODE_ARTICLE_DETAILS, NULL, 1);
+	xmlNodePtr feature = libcatner_get_child(features, LIBCATNER_NAME_FEATURE, NULL, 0);
+	char order[8];
+	order[0] = '\0';
 
-	// Find or create the DESCRIPTION_SHORT node within ARTICLE_DETAILS
-	xmlNodePtr title = libcatner_get_child(details, BMECAT_NODE_ARTICLE_TITLE, NULL, 1);
+	for (size_t i = 1; feature; feature = libcatner_next_node(feature))
+	{
+		snprintf(order, 8, "%zu", i);
+		// Update the node (create it if it didn't exist yet)
+		libcatner_set_child(feature, LIBCATNER_NAME_FEATURE_ORDER, BAD_CAST order, 1);
+		++i;
+	}
 	
-	// Set the text of the title node accordingly
-	xmlNodeSetContent(title, BAD_CAST value);
 	return 0;
 }
 
 /*
- * Sets the description (DESCRIPTION_LONG) of the article with the given AID. 
- * Returns -1 if no matching article could be found, otherwise 0.
+ * Deletes and frees the given ARTICLE node, including its bookkeeping data, 
+ * and removes it from the AID index. If the article is currently selected, 
+ * the selection will be reset.
  */
-int catner_set_article_descr(catner_state_s *cs, const char *aid, const char *value)
+static void libcatner_del_article(catner_state_s *cs, xmlNodePtr article)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) 
-		: cs->_curr_article;
-
-	if (article == NULL)
+	// Are we about to delete the currently selected article?
+	if (cs->_curr_article == article)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		cs->_curr_article = NULL;
+		cs->_curr_feature = NULL;
+		cs->_curr_variant = NULL;
+		cs->_curr_image   = NULL;
+		cs->_curr_unit    = NULL;
 	}
 
-	// Find or create the ARTICLE_DETAILS node within this ARTICLE
-	xmlNodePtr details = libcatner_get_child(article, BMECAT_NODE_ARTICLE_DETAILS, NULL, 1);
+	// Remove the article from the AID index before it is gone
+	libcatner_unindex_article(cs, article);
 
-	// Find or create the DESCRIPTION_SHORT node within ARTICLE_DETAILS
-	xmlNodePtr descr = libcatner_get_child(details, BMECAT_NODE_ARTICLE_DESCR, NULL, 1);
-	
-	// Set the text of the title node accordingly
-	xmlNodeSetContent(descr, BAD_CAST value);
-	return 0;
+	libcatner_free_article_meta(article);
+	libcatner_del_node(article);
+	--cs->_num_articles;
 }
 
-int catner_set_feature_prop(catner_state_s *cs, const char *aid, const char *fid, 
-		const char *prop, const char *value, int add)
+/*
+ * Returns 1 if the reader is positioned on a node of the given type and 
+ * depth that has the given (local) name, otherwise 0.
+ */
+static int libcatner_reader_is(xmlTextReaderPtr reader, int type, int depth, 
+		const xmlChar *name)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) 
-		: cs->_curr_article;
+	return xmlTextReaderNodeType(reader) == type && 
+		xmlTextReaderDepth(reader) == depth && 
+		xmlStrEqual(xmlTextReaderConstLocalName(reader), name);
+}
 
-	if (article == NULL)
+/*
+ * Copies the given node from another document (for example, one that is being
+ * built by a reader) and adds the copy as last child to `parent` within the 
+ * state's document. Namespaces will be mapped onto those in scope of parent, 
+ * element names onto the dictionary of the state's document. If `deep` is 1, 
+ * the node's subtree will be copied as well. Returns the copy or NULL.
+ */
+static xmlNodePtr libcatner_copy_node(catner_state_s *cs, xmlNodePtr node, 
+		xmlNodePtr parent, int deep)
+{
+	xmlNodePtr copy = NULL;
+	if (xmlDOMWrapCloneNode(NULL, node->doc, node, &copy, cs->doc, parent, deep, 0) != 0)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		return NULL;
 	}
+	return xmlAddChild(parent, copy);
+}
 
-	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
-		cs->_curr_feature;
+/*
+ * Reads from the state's reader up to the start of T_NEW_CATALOG, which is 
+ * where the articles begin. On the way, the BMECAT root (without children), 
+ * the entire HEADER and T_NEW_CATALOG (without children) are copied into the 
+ * state's document. Everything else is skipped. Returns 0 on success, -1 if 
+ * the document is not a BMEcat document or could not be parsed.
+ */
+static int libcatner_stream_header(catner_state_s *cs)
+{
+	xmlTextReaderPtr reader = cs->_reader;
 
-	if (feature == NULL)
+	int ret = xmlTextReaderRead(reader);
+	while (ret == 1)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
-		return -1;
+		// We're only interested in elements
+		if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+		{
+			ret = xmlTextReaderRead(reader);
+			continue;
+		}
+
+		int depth = xmlTextReaderDepth(reader);
+		const xmlChar *name = xmlTextReaderConstLocalName(reader);
+		xmlNodePtr node = xmlTextReaderCurrentNode(reader);
+
+		// The root element, copy it along with attributes and namespaces
+		if (depth == 0)
+		{
+			if (!xmlStrEqual(name, BMECAT_NODE_ROOT))
+			{
+				return -1;
+			}
+			cs->root = xmlDocCopyNode(node, cs->doc, 2);
+			xmlDocSetRootElement(cs->doc, cs->root);
+			ret = xmlTextReaderRead(reader);
+		}
+
+		// The HEADER, we copy the whole thing
+		else if (depth == 1 && xmlStrEqual(name, BMECAT_NODE_HEADER))
+		{
+			node = xmlTextReaderExpand(reader);
+			cs->header = node ? libcatner_copy_node(cs, node, cs->root, 1) : NULL;
+			if (cs->header == NULL)
+			{
+				return -1;
+			}
+			ret = xmlTextReaderNext(reader);
+		}
+
+		// T_NEW_CATALOG, we copy the node itself and stop here
+		else if (depth == 1 && xmlStrEqual(name, BMECAT_NODE_ARTICLES))
+		{
+			cs->articles = libcatner_copy_node(cs, node, cs->root, 0);
+			return cs->articles ? 0 : -1;
+		}
+
+		// Anything else we skip, including all children
+		else
+		{
+			ret = xmlTextReaderNext(reader);
+		}
 	}
 
-	return libcatner_set_child(feature, BAD_CAST prop, BAD_CAST value, add);
+	// Document ended without T_NEW_CATALOG or there was an error
+	return (ret == 0 && cs->root) ? 0 : -1;
 }
 
-int catner_set_feature_id(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+/*
+ * Advances the given reader, which has to be positioned within T_NEW_CATALOG,
+ * to the next ARTICLE, expands it and returns it. The returned node belongs 
+ * to the reader's document and is only valid until the next call. Returns 
+ * NULL if there are no more articles or the document could not be parsed.
+ */
+static xmlNodePtr libcatner_stream_article(xmlTextReaderPtr reader)
 {
-	const char* prop = (char *) BMECAT_NODE_FEATURE_ID;
-	return catner_set_feature_prop(cs, aid, fid, prop, value, 0);
+	// If we're still on the previous article, skip its subtree
+	int ret = libcatner_reader_is(reader, XML_READER_TYPE_ELEMENT, 2, BMECAT_NODE_ARTICLE) ?
+		xmlTextReaderNext(reader) : xmlTextReaderRead(reader);
+
+	for (; ret == 1; ret = xmlTextReaderRead(reader))
+	{
+		// We've left T_NEW_CATALOG, so there are no more articles
+		if (xmlTextReaderDepth(reader) < 2)
+		{
+			return NULL;
+		}
+
+		if (libcatner_reader_is(reader, XML_READER_TYPE_ELEMENT, 2, BMECAT_NODE_ARTICLE))
+		{
+			return xmlTextReaderExpand(reader);
+		}
+	}
+
+	return NULL;
 }
 
-int catner_set_feature_name(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+/*
+ * Returns the AID of an ARTICLE node returned by libcatner_stream_article(), 
+ * or NULL if it has none. As the node belongs to the reader's document, its 
+ * names aren't interned in our dictionary and have to be compared as strings.
+ */
+static const xmlChar *libcatner_stream_aid(xmlNodePtr article)
 {
-	const char* prop = (char *) BMECAT_NODE_FEATURE_NAME;
-	return catner_set_feature_prop(cs, aid, fid, prop, value, 1);
+	for (xmlNodePtr child = article->children; child; child = child->next)
+	{
+		if (child->type == XML_ELEMENT_NODE && xmlStrEqual(child->name, BMECAT_NODE_ARTICLE_ID))
+		{
+			return libcatner_get_text(child);
+		}
+	}
+	return NULL;
 }
 
-int catner_set_feature_descr(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+/*
+ * Book keeping for counting the articles of a file with SAX callbacks.
+ */
+struct libcatner_count
 {
-	const char* prop = (char *) BMECAT_NODE_FEATURE_DESCR;
-	return catner_set_feature_prop(cs, aid, fid, prop, value, 1);
-}
+	int depth;		// Depth of the next element, the root being at 0
+	int in_articles;	// Whether we're within T_NEW_CATALOG
+	size_t num_articles;	// Number of ARTICLE elements found so far
+};
 
-// TODO there might not be a FVALUE element yet! If so, we have to create it
-int catner_set_feature_value(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+typedef struct libcatner_count libcatner_count_s;
+
+/*
+ * SAX start element callback that counts ARTICLE elements in T_NEW_CATALOG, 
+ * but not those in T_UPDATE_PRODUCTS or other transactions.
+ */
+static void libcatner_count_start(void *ctx, const xmlChar *name, const xmlChar *prefix, 
+		const xmlChar *uri, int num_ns, const xmlChar **ns, int num_attrs, 
+		int num_defaulted, const xmlChar **attrs)
 {
-	const char* prop = (char *) BMECAT_NODE_FEATURE_VALUE;
-	return catner_set_feature_prop(cs, aid, fid, prop, value, 1);
+	(void) prefix;
+	(void) uri;
+	(void) num_ns;
+	(void) ns;
+	(void) num_attrs;
+	(void) num_defaulted;
+	(void) attrs;
+
+	libcatner_count_s *count = ctx;
+	int depth = count->depth++;
+	if (depth == 1)
+	{
+		count->in_articles = xmlStrEqual(name, BMECAT_NODE_ARTICLES);
+	}
+	else if (depth == 2 && count->in_articles && xmlStrEqual(name, BMECAT_NODE_ARTICLE))
+	{
+		++count->num_articles;
+	}
 }
 
-int catner_set_feature_unit(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+/*
+ * SAX end element callback, the counterpart of libcatner_count_start().
+ */
+static void libcatner_count_end(void *ctx, const xmlChar *name, const xmlChar *prefix, 
+		const xmlChar *uri)
 {
-	const char *v = xmlStrlen(BAD_CAST value) ? value : LIBCATNER_DEF_FEATURE_UNIT;
-	const char* prop = (char *) BMECAT_NODE_FEATURE_UNIT;
-	return catner_set_feature_prop(cs, aid, fid, prop, v, 1);
+	(void) name;
+	(void) prefix;
+	(void) uri;
+
+	libcatner_count_s *count = ctx;
+	if (--count->depth == 1)
+	{
+		count->in_articles = 0;
+	}
 }
 
-int catner_set_variant_value(catner_state_s *cs, const char *aid, const char *fid, const char *vid, const char *value)
+/*
+ * Counts the ARTICLE elements in the given file with a SAX parser, which 
+ * doesn't build any nodes. Returns 0 on success, -1 if the file couldn't 
+ * be parsed.
+ */
+static int libcatner_count_articles(const char *path, size_t *num_articles)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) : 
-		cs->_curr_article;
+	xmlSAXHandler sax = { 0 };
+	sax.initialized    = XML_SAX2_MAGIC;
+	sax.startElementNs = libcatner_count_start;
+	sax.endElementNs   = libcatner_count_end;
 
-	if (article == NULL)
+	libcatner_count_s count = { 0 };
+	xmlParserCtxtPtr ctxt = xmlNewSAXParserCtxt(&sax, &count);
+	if (ctxt == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
 		return -1;
 	}
 
-	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
-		cs->_curr_feature;
+	// No document is built, so the result tells us nothing
+	xmlCtxtReadFile(ctxt, path, NULL, 0);
+	int ok = ctxt->wellFormed;
+	xmlFreeParserCtxt(ctxt);
 
-	if (feature == NULL)
+	*num_articles = count.num_articles;
+	return ok ? 0 : -1;
+}
+
+/*
+ * AID filter for catner_load_aids(), `data` is the hash table of wanted AIDs.
+ * AIDs are removed from the table once found, so we can stop reading early.
+ */
+static int libcatner_aid_in_set(const char *aid, void *data)
+{
+	xmlHashTablePtr set = data;
+	if (xmlHashSize(set) == 0)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
 		return -1;
 	}
+	return xmlHashRemoveEntry(set, BAD_CAST aid, NULL) == 0;
+}
 
-	xmlNodePtr variant = vid ? libcatner_get_variant(feature, BAD_CAST vid) : 
-		cs->_curr_variant;
+/*
+ * Writes the attributes and namespace declarations of the given element to 
+ * the given writer, which has to be positioned right after the start tag. 
+ * Returns 0 on success, -1 if the writer reported an error.
+ */
+static int libcatner_write_attrs(xmlTextWriterPtr writer, xmlNodePtr node)
+{
+	int ret = 0;
 
-	if (variant == NULL)
+	for (xmlNsPtr ns = node->nsDef; ns; ns = ns->next)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_VID;
-		return -1;
+		ret |= ns->prefix ?
+			xmlTextWriterWriteAttributeNS(writer, BAD_CAST "xmlns", ns->prefix, NULL, ns->href) :
+			xmlTextWriterWriteAttribute(writer, BAD_CAST "xmlns", ns->href);
+	}
+
+	for (xmlAttrPtr attr = node->properties; attr; attr = attr->next)
+	{
+		xmlChar *value = xmlNodeListGetString(node->doc, attr->children, 1);
+		ret |= xmlTextWriterWriteAttribute(writer, attr->name, value ? value : BAD_CAST "");
+		xmlFree(value);
 	}
 
-	return libcatner_set_child(variant, BMECAT_NODE_VARIANT_VALUE, BAD_CAST value, 0);
+	return ret < 0 ? -1 : 0;
 }
 
-int catner_set_weight_variant(catner_state_s *cs, const char *aid, const char *vid, const char *value)
+/*
+ * Writes the given node, including its subtree, to the given writer. Only 
+ * elements (with attributes and namespace declarations), text, CDATA and 
+ * comments are written, anything else is skipped. Returns 0 on success, 
+ * -1 if the writer reported an error.
+ */
+static int libcatner_write_node(xmlTextWriterPtr writer, xmlNodePtr node)
 {
-	return catner_set_variant_value(cs, aid, LIBCATNER_FEATURE_WEIGHT, vid, value);
-}
+	int ret = 0;
 
-//
-// GET
-//
+	switch (node->type)
+	{
+		case XML_TEXT_NODE:
+			return xmlTextWriterWriteString(writer, node->content) < 0 ? -1 : 0;
+		case XML_CDATA_SECTION_NODE:
+			return xmlTextWriterWriteCDATA(writer, node->content) < 0 ? -1 : 0;
+		case XML_COMMENT_NODE:
+			return xmlTextWriterWriteComment(writer, node->content) < 0 ? -1 : 0;
+		case XML_ELEMENT_NODE:
+			break;
+		default:
+			return 0;
+	}
 
-size_t catner_get_locale(catner_state_s *cs, char *buf, size_t len)
-{
-	xmlNodePtr locale = libcatner_get_child(cs->catalog, BMECAT_NODE_LOCALE, NULL, 0);
-	return libcatner_cpy_content(locale, buf, len);
+	ret |= xmlTextWriterStartElement(writer, node->name);
+	ret |= libcatner_write_attrs(writer, node);
+
+	for (xmlNodePtr child = node->children; child; child = child->next)
+	{
+		ret |= libcatner_write_node(writer, child);
+	}
+
+	ret |= xmlTextWriterEndElement(writer);
+	return ret < 0 ? -1 : 0;
 }
 
-size_t catner_get_generator(catner_state_s *cs, char *buf, size_t len)
+/*
+ * Writes all ARTICLE nodes currently held in memory by a state that has been 
+ * created with catner_init_stream(), then deletes them. The AIDs of written 
+ * articles are remembered to be able to detect duplicates later on. If this 
+ * is the first time the function is called for this state, the document is 
+ * started and the HEADER written first. Returns 0 on success, -1 on error.
+ */
+static int libcatner_stream_flush(catner_state_s *cs)
 {
-	return libcatner_cpy_content(cs->generator, buf, len);
+	xmlTextWriterPtr writer = cs->_writer;
+	int ret = 0;
+
+	// Start the document and write the header, if we haven't done so yet
+	if (cs->_aid_written == NULL)
+	{
+		cs->_aid_written = xmlHashCreate(0);
+		if (cs->_aid_written == NULL)
+		{
+			return -1;
+		}
+
+		ret |= xmlTextWriterStartDocument(writer, LIBCATNER_XML_VERSION, 
+				LIBCATNER_XML_ENCODING, NULL);
+
+		// BMECAT and T_NEW_CATALOG stay open until catner_stream_end()
+		ret |= xmlTextWriterStartElement(writer, cs->root->name);
+		ret |= libcatner_write_attrs(writer, cs->root);
+		ret |= libcatner_write_node(writer, cs->header);
+		ret |= xmlTextWriterStartElement(writer, cs->articles->name);
+	}
+
+	xmlNodePtr article = libcatner_get_child(cs->articles, LIBCATNER_NAME_ARTICLE, NULL, 0);
+	while (article)
+	{
+		// Remember the AID, which is the only thing we keep of the article
+		xmlNodePtr id = libcatner_get_child(article, LIBCATNER_NAME_ARTICLE_ID, NULL, 0);
+		const xmlChar *aid = id ? libcatner_get_text(id) : NULL;
+		if (aid)
+		{
+			xmlHashAddEntry(cs->_aid_written, aid, cs);
+		}
+
+		ret |= libcatner_write_node(writer, article);
+
+		xmlNodePtr next = libcatner_next_node(article);
+		libcatner_del_article(cs, article);
+		article = next;
+	}
+
+	return ret < 0 ? -1 : 0;
 }
 
-size_t catner_get_territories(catner_state_s *cs, char *buf, size_t len)
+/*
+ * Creates a state around the given, freshly parsed document, which may be 
+ * NULL if parsing failed. This does the work shared by all catner_load*() 
+ * functions, see catner_load() for the meaning of `amend`. `path` is the file 
+ * to save back to and may be NULL. The document is freed on error.
+ */
+static catner_state_s *libcatner_load_doc(xmlDocPtr doc, const char *path, int amend)
 {
-	buf[0] = '\0';
+	catner_state_s *state = malloc(sizeof(catner_state_s));
+	if (state == NULL)
+	{
+		xmlFreeDoc(doc);
+		return NULL;
+	}
+	catner_state_s empty_state = { 0 };
+	*state = empty_state;
 
-	const char *comma = ",";
-	size_t cur_len = 0;
-	size_t req_len = 0;
-	xmlNodePtr t = libcatner_get_child(cs->catalog, BMECAT_NODE_TERRITORY, NULL, 0);
+	state->doc  = doc;
+	state->path = path ? strdup(path) : NULL;
+
+	// Start from scratch if the file is empty or not XML, if so requested
+	if (state->doc == NULL && amend)
+	{
+		state->doc = xmlNewDoc(BAD_CAST LIBCATNER_XML_VERSION);
+	}
+
+	// Make sure we can match element names by pointer from here on
+	if (state->doc == NULL || libcatner_intern_names(state) != 0)
+	{
+		catner_free(state);
+		return NULL;
+	}
+
+	// Find (or possibly create) the BMECAT, HEADER, T_NEW_CATALOG and 
+	// CATALOG nodes; GENERATOR_INFO is optional and won't be created
+	state->root      = libcatner_get_root(state->doc, amend);
+	state->header    = state->root ? libcatner_get_header(state->root, amend) : NULL;
+	state->articles  = state->root ? libcatner_get_articles(state->root, amend) : NULL;
+	state->catalog   = state->header ? libcatner_get_catalog(state->header, amend) : NULL;
+	state->generator = state->header ? libcatner_get_generator(state->header, 0) : NULL;
+
+	if (state->articles == NULL || state->catalog == NULL)
+	{
+		catner_free(state);
+		return NULL;
+	}
+
+	// Index all existing articles by their AID
+	if (libcatner_build_aid_index(state) != 0)
+	{
+		catner_free(state);
+		return NULL;
+	}
+	
+	return state;
+}
+
+/*
+ * Creates a parser context for the given load options, which may be NULL, 
+ * and stores the matching parser options in `options`. If the options name 
+ * a shared dictionary, the context will use it instead of its own one. 
+ * Returns NULL if out of memory.
+ */
+static xmlParserCtxtPtr libcatner_new_parser(const catner_load_opts_s *opts, int *options)
+{
+	xmlParserCtxtPtr ctxt = xmlNewParserCtxt();
+	if (ctxt == NULL || opts == NULL)
+	{
+		*options = 0;
+		return ctxt;
+	}
 
-	// TODO xmlFree(t_str)
-	for (; t; t = libcatner_next_node(t))
+	// Swap the context's own dictionary for the shared one
+	if (opts->dict)
 	{
-		char *t_str = (char *) xmlNodeGetContent(t);
-		size_t t_len = strlen(t_str);
+		xmlDictFree(ctxt->dict);
+		xmlDictReference(opts->dict);
+		ctxt->dict = opts->dict;
+	}
+
+	*options = 0;
+	*options |= opts->noblanks ? XML_PARSE_NOBLANKS : 0;
+	*options |= opts->compact  ? XML_PARSE_COMPACT  : 0;
+	*options |= opts->huge     ? XML_PARSE_HUGE     : 0;
+	return ctxt;
+}
+
+/*
+ * Input for the parser that is made up of several consecutive byte ranges, 
+ * so we can parse parts of a file without copying them together first.
+ */
+struct libcatner_pieces
+{
+	const char *buf[4];	// Start of each range, advanced while reading
+	size_t len[4];		// Bytes left in each range
+	size_t curr;		// Range we're currently reading from
+};
+
+typedef struct libcatner_pieces libcatner_pieces_s;
+
+/*
+ * Read callback for xmlCtxtReadIO(), feeding the ranges in order.
+ */
+static int libcatner_read_pieces(void *ctx, char *buf, int len)
+{
+	libcatner_pieces_s *src = ctx;
+	int num = 0;
 
-		req_len += (t_len + (cur_len != 0));
-		if ((req_len + 1) > len)
+	while (num < len && src->curr < 4)
+	{
+		size_t left = src->len[src->curr];
+		if (left == 0)
 		{
+			++src->curr;
 			continue;
 		}
-		
-		if (cur_len)
-		{
-			strncat(buf, comma, 1);
-		}
-		
-		strncat(buf, t_str, t_len);
-		cur_len = req_len;
-	}
 
-	buf[cur_len] = '\0';
-	return req_len + 1;
+		size_t take = left < (size_t) (len - num) ? left : (size_t) (len - num);
+		memcpy(buf + num, src->buf[src->curr], take);
+		src->buf[src->curr] += take;
+		src->len[src->curr] -= take;
+		num += take;
+	}
+	return num;
 }
 
-size_t catner_get_article_aid(catner_state_s *cs, char *buf, size_t len)
+/*
+ * Parses the given ranges as one document. Returns NULL if the ranges don't 
+ * make up a well-formed document or if out of memory.
+ */
+static xmlDocPtr libcatner_parse_pieces(libcatner_pieces_s *src, const char *url, 
+		const catner_load_opts_s *opts)
 {
-	if (cs->_curr_article == NULL)
+	int options = 0;
+	xmlParserCtxtPtr ctxt = libcatner_new_parser(opts, &options);
+	if (ctxt == NULL)
 	{
-		return libcatner_cpy_content(NULL, buf, len);
+		return NULL;
 	}
 
-	xmlNodePtr aid = libcatner_get_child(cs->_curr_article, BMECAT_NODE_ARTICLE_ID, NULL, 0);
-	return libcatner_cpy_content(aid, buf, len);
+	// Errors are reported when the caller falls back to parsing the whole file
+	options |= XML_PARSE_NOERROR | XML_PARSE_NOWARNING;
+	xmlDocPtr doc = xmlCtxtReadIO(ctxt, libcatner_read_pieces, NULL, src, url, NULL, options);
+	xmlFreeParserCtxt(ctxt);
+	return doc;
 }
 
-size_t catner_get_article_title(catner_state_s *cs, const char *aid, char *buf, size_t len)
+/*
+ * Returns a pointer to the first start tag of an element called `name` in the 
+ * range from `p` to `end`, or NULL if there is none. Prefixed names, as in 
+ * `<bme:ARTICLE>`, are not recognized. 
+ */
+static const char *libcatner_find_tag(const char *p, const char *end, const char *name)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) : 
-		cs->_curr_article;
+	size_t len = strlen(name);
+	for (; (p = memchr(p, '<', end - p)) != NULL; ++p)
+	{
+		if ((size_t) (end - p) < len + 2 || strncmp(p + 1, name, len) != 0)
+		{
+			continue;
+		}
 
-	if (article == NULL)
+		char c = p[len + 1];
+		if (c == '>' || c == '/' || c == ' ' || c == '\t' || c == '\r' || c == '\n')
+		{
+			return p;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Returns a pointer to the last end tag of an element called `name` in the 
+ * range from `start` to `end`, or NULL if there is none.
+ */
+static const char *libcatner_find_end_tag(const char *start, const char *end, const char *name)
+{
+	size_t len = strlen(name);
+	if ((size_t) (end - start) < len + 3)
 	{
-		return libcatner_cpy_content(NULL, buf, len);
+		return NULL;
 	}
 
-	xmlNodePtr title = libcatner_get_child(article, BMECAT_NODE_ARTICLE_TITLE, NULL, 0);
-	return libcatner_cpy_content(title, buf, len);
+	for (size_t off = end - start - len - 2; off-- > 0; )
+	{
+		const char *p = start + off;
+		if (p[0] != '<' || p[1] != '/' || strncmp(p + 2, name, len) != 0)
+		{
+			continue;
+		}
+
+		char c = p[len + 2];
+		if (c == '>' || c == ' ' || c == '\t' || c == '\r' || c == '\n')
+		{
+			return p;
+		}
+	}
+	return NULL;
 }
 
-size_t catner_get_article_descr(catner_state_s *cs, const char *aid, char *buf, size_t len)
+/*
+ * Returns a pointer just past the end of the tag that starts at `p`, taking 
+ * quoted attribute values into account, or NULL if the tag isn't closed.
+ */
+static const char *libcatner_skip_tag(const char *p, const char *end)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	char quote = 0;
+	for (; p < end; ++p)
+	{
+		if (quote)
+		{
+			quote = (*p == quote) ? 0 : quote;
+		}
+		else if (*p == '"' || *p == '\'')
+		{
+			quote = *p;
+		}
+		else if (*p == '>')
+		{
+			return p + 1;
+		}
+	}
+	return NULL;
+}
 
-	if (article == NULL)
+/*
+ * Returns a pointer to the start tag of the root element, skipping the XML 
+ * declaration, processing instructions and comments. Returns NULL if there is 
+ * a DOCTYPE, as its entities might be needed to parse the articles.
+ */
+static const char *libcatner_find_root(const char *p, const char *end)
+{
+	for (; (p = memchr(p, '<', end - p)) != NULL; ++p)
 	{
-		return libcatner_cpy_content(NULL, buf, len);
+		if (end - p < 4 || (p[1] == '!' && (p[2] != '-' || p[3] != '-')))
+		{
+			return NULL;
+		}
+		if (p[1] == '!')
+		{
+			// Comment, skip ahead to the `-->`
+			do
+			{
+				p = memchr(p + 1, '>', end - p - 1);
+			}
+			while (p && (p[-1] != '-' || p[-2] != '-'));
+		}
+		else if (p[1] == '?')
+		{
+			p = memchr(p, '>', end - p);
+		}
+		else
+		{
+			return p;
+		}
+		if (p == NULL)
+		{
+			return NULL;
+		}
 	}
+	return NULL;
+}
 
-	xmlNodePtr descr = libcatner_get_child(article, BMECAT_NODE_ARTICLE_DESCR, NULL, 0);
-	return libcatner_cpy_content(descr, buf, len);
+/*
+ * A slice of the articles in a file, along with the document it parses to.
+ */
+struct libcatner_chunk
+{
+	libcatner_pieces_s src;	// Root and T_NEW_CATALOG tags, articles, rest
+	const char *url;	// Path of the file, for error messages
+	catner_load_opts_s opts;// Load options, without a shared dictionary
+	xmlDocPtr doc;		// Parsed chunk, NULL on error
+	pthread_t thread;	// Thread parsing the chunk
+	int started;		// Whether `thread` was started
+};
+
+typedef struct libcatner_chunk libcatner_chunk_s;
+
+/*
+ * Thread function that parses a chunk.
+ */
+static void *libcatner_parse_chunk(void *arg)
+{
+	libcatner_chunk_s *chunk = arg;
+	chunk->doc = libcatner_parse_pieces(&chunk->src, chunk->url, &chunk->opts);
+	return NULL;
 }
 
 /*
- * Gets the article's _main_ unit
- * TODO proper documentation
+ * Returns the T_NEW_CATALOG node of the given, not yet indexed document if it 
+ * is the only one found under the root element, otherwise NULL.
  */
-size_t catner_get_article_unit(catner_state_s *cs, const char *aid, char *buf, size_t len)
+static xmlNodePtr libcatner_find_articles(xmlDocPtr doc)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	xmlNodePtr root = doc ? xmlDocGetRootElement(doc) : NULL;
+	xmlNodePtr articles = NULL;
 
-	if (article == NULL)
+	for (xmlNodePtr child = root ? root->children : NULL; child; child = child->next)
 	{
-		return libcatner_cpy_content(NULL, buf, len);
+		if (child->type != XML_ELEMENT_NODE || !xmlStrEqual(child->name, BMECAT_NODE_ARTICLES))
+		{
+			continue;
+		}
+		if (articles)
+		{
+			return NULL;
+		}
+		articles = child;
 	}
+	return articles;
+}
 
-	xmlNodePtr units = libcatner_get_child(article, BMECAT_NODE_ARTICLE_UNITS, NULL, 0);
-
-	if (units == NULL)
+/*
+ * Moves the children of the T_NEW_CATALOG node of `doc` to the T_NEW_CATALOG 
+ * node of the given state and indexes the articles among them. `doc` remains
+ * to be freed by the caller. Returns 0 on success, -1 on error.
+ */
+static int libcatner_splice_articles(catner_state_s *cs, xmlDocPtr doc)
+{
+	xmlNodePtr articles = libcatner_find_articles(doc);
+	if (articles == NULL)
 	{
-		return libcatner_cpy_content(NULL, buf, len);
+		return -1;
 	}
 
-	xmlNodePtr munit = libcatner_get_child(units, BMECAT_NODE_ARTICLE_MAIN_UNIT, NULL, 0);
-	return libcatner_cpy_content(munit, buf, len);
+	const xmlChar *article_name = libcatner_name(cs->root, LIBCATNER_NAME_ARTICLE);
+	xmlNodePtr child = articles->children;
+	while (child)
+	{
+		xmlNodePtr next = child->next;
+		xmlUnlinkNode(child);
+
+		// This also moves the names into our dictionary, so we can compare them
+		if (xmlDOMWrapAdoptNode(NULL, doc, child, cs->doc, cs->articles, 0) != 0)
+		{
+			xmlFreeNode(child);
+			return -1;
+		}
+
+		int is_article = child->type == XML_ELEMENT_NODE && child->name == article_name;
+		xmlAddChild(cs->articles, child);
+		if (is_article)
+		{
+			libcatner_index_article(cs, child);
+			++cs->_num_articles;
+		}
+		child = next;
+	}
+	return 0;
 }
 
-size_t catner_get_article_categories(catner_state_s *cs, const char *aid, char *buf, size_t len)
+/*
+ * Does the actual work for catner_load_parallel() on the `len` bytes of the 
+ * file mapped at `file`. Returns NULL if the file can't be loaded this way, 
+ * in which case the caller should load it the usual way.
+ */
+static catner_state_s *libcatner_load_chunked(const char *file, size_t len, 
+		const char *path, int amend, int threads, const catner_load_opts_s *opts)
 {
-	// Make sure buf passes as an empty, 0-terminated string
-	buf[0] = '\0';
+	const char *end = file + len;
+	const char *name = (const char *) BMECAT_NODE_ARTICLES;
 
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
-	
-	if (article == NULL)
+	// Find the root start tag as well as the start and end tag of T_NEW_CATALOG
+	const char *root = libcatner_find_root(file, end);
+	const char *root_end = root ? libcatner_skip_tag(root, end) : NULL;
+	const char *open = root_end ? libcatner_find_tag(root_end, end, name) : NULL;
+	const char *open_end = open ? libcatner_skip_tag(open, end) : NULL;
+	const char *close = open_end ? libcatner_find_end_tag(open_end, end, name) : NULL;
+	if (close == NULL || root_end[-2] == '/' || open_end[-2] == '/')
 	{
-		return 0;
+		return NULL;
 	}
 
-	// Iterate all categories, concat each to the buffer
-	const char *comma = ",";
-	size_t cur_len = 0;
-	size_t req_len = 0;
-	xmlNodePtr unit = libcatner_get_child(article, BMECAT_NODE_ARTICLE_CATEGORY, NULL, 0);
+	libcatner_chunk_s *chunks = calloc(threads, sizeof(libcatner_chunk_s));
+	if (chunks == NULL)
+	{
+		return NULL;
+	}
 
-	// TODO xmlFree(unit_id_str)
-	for (; unit; unit = libcatner_next_node(unit))
+	// Wrap each chunk of articles in copies of the root and T_NEW_CATALOG tags
+	int num_chunks = 0;
+	const char *from = open_end;
+	for (int i = 1; i <= threads && from < close; ++i)
 	{
-		// Get the inner CATALOG_ID node that actually holds the category
-		xmlNodePtr unit_id = libcatner_get_child(unit, BMECAT_NODE_ARTICLE_CATEGORY_ID, NULL, 0);
-		if (unit_id == NULL)
+		const char *to = close;
+		if (i < threads)
 		{
-			continue;
+			const char *target = open_end + (close - open_end) / threads * i;
+			to = libcatner_find_tag(target > from ? target : from + 1, close, 
+					(const char *) BMECAT_NODE_ARTICLE);
+			to = to ? to : close;
 		}
-		
-		// Extract the actual category ID string
-		char *unit_id_str = (char *) xmlNodeGetContent(unit_id);
 
-		// Get the length of the current ID (should be 8, but let's check)
-		size_t id_len = strlen(unit_id_str);
+		libcatner_chunk_s *chunk = &chunks[num_chunks++];
+		chunk->src  = (libcatner_pieces_s) {
+			.buf = { file, open, from, close },
+			.len = { root_end - file, open_end - open, to - from, end - close }
+		};
+		chunk->url  = path;
+		chunk->opts = opts ? *opts : (catner_load_opts_s) { 0 };
+		chunk->opts.dict = NULL;
+		from = to;
+	}
+
+	// Parse the chunks in the background, falling back to doing it ourselves
+	xmlInitParser();
+	for (int i = 0; i < num_chunks; ++i)
+	{
+		chunks[i].started = pthread_create(&chunks[i].thread, NULL, 
+				libcatner_parse_chunk, &chunks[i]) == 0;
+	}
 
-		// Update the required buffer lenght (in case it ain't big enough)
-		req_len += (id_len + (cur_len != 0));
+	// The header is everything but the articles, which we parse meanwhile
+	libcatner_pieces_s header = {
+		.buf = { file, close },
+		.len = { open_end - file, end - close }
+	};
+	xmlDocPtr doc = libcatner_parse_pieces(&header, path, opts);
 
-		// We're not concating if we'd be exeeding the buffer
-		if ((req_len + 1) > len)
+	int ok = libcatner_find_articles(doc) != NULL;
+	for (int i = 0; i < num_chunks; ++i)
+	{
+		if (chunks[i].started)
 		{
-			// We'll still continue though in order to sum up the required length
-			continue;
+			pthread_join(chunks[i].thread, NULL);
 		}
-		
-		// Maybe add a comma
-		if (cur_len)
+		else
 		{
-			strncat(buf, comma, 1);
+			libcatner_parse_chunk(&chunks[i]);
 		}
-		// Definitely add the category ID
-		strncat(buf, unit_id_str, id_len);
+		ok = ok && chunks[i].doc != NULL;
+	}
 
-		// Update the number of characters written (not including '\0')
-		cur_len = req_len;
+	catner_state_s *state = NULL;
+	if (ok)
+	{
+		state = libcatner_load_doc(doc, path, amend);
+		doc = NULL;
 	}
-	
-	buf[cur_len] = '\0'; // Make sure we're properly terminated
-	return req_len + 1; // Include required length (including '\0')
+
+	for (int i = 0; i < num_chunks; ++i)
+	{
+		if (state && libcatner_splice_articles(state, chunks[i].doc) != 0)
+		{
+			catner_free(state);
+			state = NULL;
+		}
+		xmlFreeDoc(chunks[i].doc);
+	}
+
+	xmlFreeDoc(doc);
+	free(chunks);
+	return state;
 }
 
-size_t catner_get_sel_article_id(catner_state_s *cs, char *buf, size_t len)
+/*
+ * Output callbacks for xmlOutputBufferCreateIO(), writing to a stdio stream.
+ */
+static int libcatner_write_file(void *ctx, const char *buf, int len)
 {
-	if (cs->_curr_article == NULL)
+	return fwrite(buf, 1, len, ctx) == (size_t) len ? len : -1;
+}
+
+static int libcatner_close_file(void *ctx)
+{
+	return fclose(ctx) == 0 ? 0 : -1;
+}
+
+/*
+ * Output callbacks for xmlOutputBufferCreateIO(), writing to a gzip stream.
+ */
+static int libcatner_write_gzip(void *ctx, const char *buf, int len)
+{
+	return gzwrite(ctx, buf, len) == len ? len : -1;
+}
+
+static int libcatner_close_gzip(void *ctx)
+{
+	return gzclose(ctx) == Z_OK ? 0 : -1;
+}
+
+/*
+ * Returns an output buffer that writes to the given file descriptor according
+ * to the given options. The descriptor is closed along with the buffer, or 
+ * right away if the buffer can't be created, in which case NULL is returned.
+ */
+static xmlOutputBufferPtr libcatner_open_output(int fd, const catner_save_opts_s *opts)
+{
+	xmlOutputBufferPtr out = NULL;
+
+	if (opts->gzip)
+	{
+		char mode[] = { 'w', 'b', '0' + opts->gzip, '\0' };
+		gzFile gz = gzdopen(fd, mode);
+		if (gz == NULL)
+		{
+			close(fd);
+			return NULL;
+		}
+		if (opts->buffer_size)
+		{
+			gzbuffer(gz, opts->buffer_size);
+		}
+
+		out = xmlOutputBufferCreateIO(libcatner_write_gzip, libcatner_close_gzip, gz, NULL);
+		if (out == NULL)
+		{
+			gzclose(gz);
+		}
+		return out;
+	}
+
+	FILE *fp = fdopen(fd, "wb");
+	if (fp == NULL)
+	{
+		close(fd);
+		return NULL;
+	}
+	if (opts->buffer_size)
+	{
+		setvbuf(fp, NULL, _IOFBF, opts->buffer_size);
+	}
+
+	out = xmlOutputBufferCreateIO(libcatner_write_file, libcatner_close_file, fp, NULL);
+	if (out == NULL)
+	{
+		fclose(fp);
+	}
+	return out;
+}
+
+/*
+ * Growable memory buffer for catner_write_xml_mem().
+ */
+struct libcatner_membuf
+{
+	char *data;		// Start of the buffer, NULL until the first write
+	size_t len;		// Number of bytes written
+	size_t size;		// Number of bytes allocated
+};
+
+typedef struct libcatner_membuf libcatner_membuf_s;
+
+/*
+ * Output callback for xmlOutputBufferCreateIO(), appending to a memory buffer
+ * whose size is doubled whenever it runs out of space.
+ */
+static int libcatner_write_mem(void *ctx, const char *buf, int len)
+{
+	libcatner_membuf_s *mem = ctx;
+
+	if (mem->size - mem->len < (size_t) len)
+	{
+		size_t size = mem->size ? mem->size : 4096;
+		while (size - mem->len < (size_t) len)
+		{
+			size *= 2;
+		}
+
+		char *data = realloc(mem->data, size);
+		if (data == NULL)
+		{
+			return -1;
+		}
+		mem->data = data;
+		mem->size = size;
+	}
+
+	memcpy(mem->data + mem->len, buf, len);
+	mem->len += len;
+	return len;
+}
+
+/*
+ * Serializes the document to the given output buffer, which may be NULL if 
+ * creating it failed, and closes it. Returns the number of bytes written or 
+ * -1 on error, in which case the state's error is set.
+ */
+static int libcatner_save_to(catner_state_s *cs, xmlOutputBufferPtr out, int indent)
+{
+	if (out == NULL)
+	{
+		cs->error = LIBCATNER_ERR_OTHER;
+		return -1;
+	}
+
+	// This closes the buffer in any case
+	int ret = xmlSaveFormatFileTo(out, cs->doc, LIBCATNER_XML_ENCODING, indent);
+	if (ret < 0)
+	{
+		cs->error = LIBCATNER_ERR_OTHER;
+		return -1;
+	}
+	return ret;
+}
+
+/*
+ * Flushes the directory that contains `path` to disk, so that a file that 
+ * has just been renamed to `path` will survive a crash under its new name.
+ * Returns 0 on success, -1 on error.
+ */
+static int libcatner_sync_dir(const char *path)
+{
+	const char *slash = strrchr(path, '/');
+	char *dir = slash ? strndup(path, slash == path ? 1 : slash - path) : strdup(".");
+	if (dir == NULL)
+	{
+		return -1;
+	}
+
+	int fd = open(dir, O_RDONLY | O_DIRECTORY);
+	free(dir);
+	if (fd == -1)
+	{
+		return -1;
+	}
+
+	int ret = fsync(fd);
+	close(fd);
+	return ret;
+}
+
+/*
+ * Creates a new file next to `path`, named like it plus a random suffix, 
+ * and opens it for writing. The name is returned in `tmp`, which has to be 
+ * freed by the caller. As the file is created with mode 0666, the umask 
+ * applies as it would to any new file. Returns the descriptor or -1 on error.
+ */
+static int libcatner_open_temp(const char *path, char **tmp)
+{
+	const char *chars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+	size_t len = strlen(path);
+
+	*tmp = malloc(len + sizeof(".XXXXXX"));
+	if (*tmp == NULL)
+	{
+		return -1;
+	}
+	memcpy(*tmp, path, len);
+	memcpy(*tmp + len, ".XXXXXX", sizeof(".XXXXXX"));
+
+	// Good enough to avoid collisions, O_EXCL makes sure we never clobber
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	unsigned long r = (unsigned long) ts.tv_nsec ^ ((unsigned long) getpid() << 16) ^ 
+		(unsigned long) (uintptr_t) tmp;
+
+	for (int tries = 0; tries < 100; ++tries)
+	{
+		r = r * 6364136223846793005UL + 1442695040888963407UL;
+		unsigned long v = r >> 16;
+		for (size_t i = 1; i < sizeof(".XXXXXX") - 1; ++i, v /= 62)
+		{
+			(*tmp)[len + i] = chars[v % 62];
+		}
+
+		int fd = open(*tmp, O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0666);
+		if (fd != -1 || errno != EEXIST)
+		{
+			return fd;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Writes the document to a temporary file next to `path`, flushes it to disk 
+ * unless the options say otherwise and renames it to `path`, so that `path` 
+ * holds either the old or the new document at all times, even if we crash. 
+ * If `path` is a symbolic link, the file it points to is replaced instead. 
+ * The file mode and, as far as permitted, owner and group of an existing 
+ * file are kept. Hard links to it will keep referring to the old contents, 
+ * as the file is replaced, not rewritten. Returns the number of bytes 
+ * written or -1 on error, in which case the state's error is set.
+ */
+static int libcatner_save_atomic(catner_state_s *cs, const char *path, const catner_save_opts_s *opts)
+{
+	// Replace the file a symbolic link points to, not the link itself
+	char *real = realpath(path, NULL);
+	const char *target = real ? real : path;
+
+	char *tmp = NULL;
+	int fd = libcatner_open_temp(target, &tmp);
+	if (fd == -1)
+	{
+		cs->error = tmp ? LIBCATNER_ERR_OTHER : LIBCATNER_ERR_OUT_OF_MEMORY;
+		free(tmp);
+		free(real);
+		return -1;
+	}
+
+	// Take over owner, group and mode; chown first, as it may clear set-ID bits
+	struct stat st;
+	if (stat(target, &st) == 0)
+	{
+		if (fchown(fd, st.st_uid, st.st_gid) != 0)
+		{
+			// Not permitted to give the file away, it stays ours
+		}
+		fchmod(fd, st.st_mode & 07777);
+	}
+
+	// Keep a descriptor of our own, as the output buffer closes its one
+	int sync_fd = dup(fd);
+	int ret = sync_fd == -1 ? -1 : 
+		libcatner_save_to(cs, libcatner_open_output(fd, opts), opts->indent);
+	if (sync_fd == -1)
+	{
+		close(fd);
+	}
+
+	if (ret >= 0 && !opts->nosync && fsync(sync_fd) != 0)
+	{
+		ret = -1;
+	}
+	if (sync_fd != -1)
+	{
+		close(sync_fd);
+	}
+
+	if (ret >= 0 && rename(tmp, target) != 0)
+	{
+		ret = -1;
+	}
+	if (ret < 0)
+	{
+		unlink(tmp);
+		free(tmp);
+		free(real);
+		cs->error = LIBCATNER_ERR_OTHER;
+		return -1;
+	}
+
+	// The file is in place already, failing here only affects durability
+	if (!opts->nosync)
+	{
+		libcatner_sync_dir(target);
+	}
+
+	free(tmp);
+	free(real);
+	return ret;
+}
+
+/*
+ * Returns 1 if the given node has text, CDATA or entity reference children, 
+ * which makes libxml write its children without indentation, otherwise 0.
+ */
+static int libcatner_has_text(const xmlNodePtr node)
+{
+	for (xmlNodePtr child = node->children; child; child = child->next)
+	{
+		if (child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE || 
+				child->type == XML_ENTITY_REF_NODE)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * A range of children of T_NEW_CATALOG, serialized by one thread.
+ */
+struct libcatner_part
+{
+	xmlDocPtr doc;		// Document the nodes belong to
+	xmlNodePtr first;	// First node of the range
+	size_t num_nodes;	// Number of nodes in the range
+	int format;		// Whether to indent, as libxml would at this point
+	int indent_tree;	// Caller's xmlIndentTreeOutput
+	const char *indent;	// Caller's xmlTreeIndentString
+	int no_empty;		// Caller's xmlSaveNoEmptyTags
+	libcatner_membuf_s mem;	// Serialized nodes
+	size_t *ends;		// If not NULL, end of each node in `mem`
+	int ret;		// 0 on success, -1 on error
+	pthread_t thread;	// Thread serializing the range
+	int started;		// Whether `thread` was started
+};
+
+typedef struct libcatner_part libcatner_part_s;
+
+/*
+ * Thread function that serializes a range of T_NEW_CATALOG's children into 
+ * memory, exactly as xmlSaveFormatFileEnc() would as part of the document.
+ */
+static void *libcatner_dump_part(void *arg)
+{
+	libcatner_part_s *part = arg;
+
+	// These are per thread, so we have to copy the caller's settings
+	xmlIndentTreeOutput = part->indent_tree;
+	xmlTreeIndentString = part->indent;
+	xmlSaveNoEmptyTags  = part->no_empty;
+
+	xmlOutputBufferPtr out = xmlOutputBufferCreateIO(libcatner_write_mem, NULL, &part->mem, NULL);
+	if (out == NULL)
+	{
+		part->ret = -1;
+		return NULL;
+	}
+
+	xmlNodePtr node = part->first;
+	for (size_t i = 0; i < part->num_nodes; ++i, node = node->next)
+	{
+		// Children of T_NEW_CATALOG are on level 2, below BMECAT
+		if (part->format && part->indent_tree)
+		{
+			xmlOutputBufferWriteString(out, part->indent);
+			xmlOutputBufferWriteString(out, part->indent);
+		}
+		xmlNodeDumpOutput(out, part->doc, node, 2, part->format, LIBCATNER_XML_ENCODING);
+		if (part->format)
+		{
+			xmlOutputBufferWrite(out, 1, "\n");
+		}
+		if (part->ends)
+		{
+			xmlOutputBufferFlush(out);
+			part->ends[i] = part->mem.len;
+		}
+	}
+
+	part->ret = xmlOutputBufferClose(out) < 0 ? -1 : 0;
+	return NULL;
+}
+
+/*
+ * Splits the `num_nodes` children of T_NEW_CATALOG into `num_parts` ranges 
+ * of (almost) the same number of nodes and starts serializing each of them 
+ * in its own thread. If `ends` is not NULL, it receives the end of every 
+ * node within its part's buffer. Parts whose thread could not be started are 
+ * serialized in libcatner_join_part() instead.
+ */
+static void libcatner_start_parts(catner_state_s *cs, libcatner_part_s *parts, int num_parts, 
+		size_t num_nodes, int format, size_t *ends)
+{
+	xmlNodePtr node = cs->articles->children;
+	for (int i = 0; i < num_parts; ++i)
+	{
+		libcatner_part_s *part = &parts[i];
+		part->doc         = cs->doc;
+		part->first       = node;
+		part->num_nodes   = num_nodes / num_parts + ((size_t) i < num_nodes % num_parts);
+		part->format      = format;
+		part->indent_tree = xmlIndentTreeOutput;
+		part->indent      = xmlTreeIndentString;
+		part->no_empty    = xmlSaveNoEmptyTags;
+		part->ends        = ends;
+
+		for (size_t n = 0; n < part->num_nodes; ++n)
+		{
+			node = node->next;
+		}
+		if (ends)
+		{
+			ends += part->num_nodes;
+		}
+		part->started = pthread_create(&part->thread, NULL, libcatner_dump_part, part) == 0;
+	}
+}
+
+/*
+ * Waits for the given part to be serialized. Returns 0 on success, else -1.
+ */
+static int libcatner_join_part(libcatner_part_s *part)
+{
+	if (part->started)
+	{
+		pthread_join(part->thread, NULL);
+	}
+	else
+	{
+		libcatner_dump_part(part);
+	}
+	return part->ret;
+}
+
+/*
+ * Writes the start tag of the given element, with its namespace declarations 
+ * and attributes, the way libxml does. The element is assumed to have 
+ * children, so the tag is never self-closing.
+ */
+static void libcatner_dump_start_tag(xmlOutputBufferPtr out, xmlDocPtr doc, xmlNodePtr node)
+{
+	xmlOutputBufferWrite(out, 1, "<");
+	if (node->ns && node->ns->prefix)
+	{
+		xmlOutputBufferWriteString(out, (const char *) node->ns->prefix);
+		xmlOutputBufferWrite(out, 1, ":");
+	}
+	xmlOutputBufferWriteString(out, (const char *) node->name);
+
+	// libxml serializes namespace declarations just like nodes
+	for (xmlNsPtr ns = node->nsDef; ns; ns = ns->next)
+	{
+		xmlNodeDumpOutput(out, doc, (xmlNodePtr) ns, 0, 0, LIBCATNER_XML_ENCODING);
+	}
+	for (xmlAttrPtr attr = node->properties; attr; attr = attr->next)
+	{
+		xmlNodeDumpOutput(out, doc, (xmlNodePtr) attr, 0, 0, LIBCATNER_XML_ENCODING);
+	}
+	xmlOutputBufferWrite(out, 1, ">");
+}
+
+/*
+ * Writes the end tag of the given element.
+ */
+static void libcatner_dump_end_tag(xmlOutputBufferPtr out, xmlNodePtr node)
+{
+	xmlOutputBufferWrite(out, 2, "</");
+	if (node->ns && node->ns->prefix)
+	{
+		xmlOutputBufferWriteString(out, (const char *) node->ns->prefix);
+		xmlOutputBufferWrite(out, 1, ":");
+	}
+	xmlOutputBufferWriteString(out, (const char *) node->name);
+	xmlOutputBufferWrite(out, 1, ">");
+}
+
+/*
+ * Serializes the document without the children of T_NEW_CATALOG, like 
+ * xmlSaveFormatFileTo() would, and returns what comes before and after them 
+ * in `head` and `tail`, which point into `mem`. The document is only read, 
+ * so other threads may keep reading it meanwhile: everything but the root 
+ * element and T_NEW_CATALOG is serialized by libxml, the tags of those two 
+ * are written here. Returns 0 on success, -1 on error or if the document 
+ * isn't laid out as expected.
+ */
+static int libcatner_dump_skeleton(catner_state_s *cs, int format, libcatner_membuf_s *mem, 
+		const char **head, size_t *head_len, const char **tail, size_t *tail_len)
+{
+	xmlDocPtr doc = cs->doc;
+	xmlNodePtr root = cs->root;
+	if (root == NULL || root->parent != (xmlNodePtr) doc || cs->articles->parent != root)
+	{
+		return -1;
+	}
+
+	// libxml only indents below elements without text
+	int root_format = !libcatner_has_text(root);
+	int indent = root_format && xmlIndentTreeOutput;
+	for (xmlNodePtr node = root->children; node && root_format; node = node->next)
+	{
+		if (node->type != XML_ELEMENT_NODE)
+		{
+			return -1;
+		}
+	}
+
+	xmlOutputBufferPtr out = xmlOutputBufferCreateIO(libcatner_write_mem, NULL, mem, NULL);
+	if (out == NULL)
+	{
+		return -1;
+	}
+
+	xmlOutputBufferWrite(out, 15, "<?xml version=\"");
+	xmlOutputBufferWriteString(out, doc->version ? (const char *) doc->version : "1.0");
+	xmlOutputBufferWrite(out, 12, "\" encoding=\"");
+	xmlOutputBufferWriteString(out, LIBCATNER_XML_ENCODING);
+	xmlOutputBufferWrite(out, 1, "\"");
+	if (doc->standalone == 0 || doc->standalone == 1)
+	{
+		xmlOutputBufferWriteString(out, doc->standalone ? 
+				" standalone=\"yes\"" : " standalone=\"no\"");
+	}
+	xmlOutputBufferWrite(out, 3, "?>\n");
+
+	size_t head_end = 0;
+	for (xmlNodePtr node = doc->children; node; node = node->next)
+	{
+		if (node != root)
+		{
+			xmlNodeDumpOutput(out, doc, node, 0, 1, LIBCATNER_XML_ENCODING);
+			xmlOutputBufferWrite(out, 1, "\n");
+			continue;
+		}
+
+		libcatner_dump_start_tag(out, doc, root);
+		if (root_format)
+		{
+			xmlOutputBufferWrite(out, 1, "\n");
+		}
+		for (xmlNodePtr child = root->children; child; child = child->next)
+		{
+			if (indent)
+			{
+				xmlOutputBufferWriteString(out, xmlTreeIndentString);
+			}
+			if (child != cs->articles)
+			{
+				xmlNodeDumpOutput(out, doc, child, 1, root_format, LIBCATNER_XML_ENCODING);
+			}
+			else
+			{
+				// The children of T_NEW_CATALOG go in between
+				libcatner_dump_start_tag(out, doc, child);
+				if (format)
+				{
+					xmlOutputBufferWrite(out, 1, "\n");
+				}
+				xmlOutputBufferFlush(out);
+				head_end = mem->len;
+				if (format && xmlIndentTreeOutput)
+				{
+					xmlOutputBufferWriteString(out, xmlTreeIndentString);
+				}
+				libcatner_dump_end_tag(out, child);
+			}
+			if (root_format)
+			{
+				xmlOutputBufferWrite(out, 1, "\n");
+			}
+		}
+		libcatner_dump_end_tag(out, root);
+		xmlOutputBufferWrite(out, 1, "\n");
+	}
+
+	if (xmlOutputBufferClose(out) < 0)
+	{
+		return -1;
+	}
+
+	*head = mem->data;
+	*head_len = head_end;
+	*tail = mem->data + head_end;
+	*tail_len = mem->len - head_end;
+	return 0;
+}
+
+/*
+ * Checks that the given file name pattern contains exactly one conversion, 
+ * which has to be `%d`, optionally with flags and field width, like `%03d`. 
+ * Returns 0 if that is the case, otherwise -1.
+ */
+static int libcatner_check_pattern(const char *pattern)
+{
+	int conversions = 0;
+	for (const char *c = pattern; *c; ++c)
+	{
+		if (*c != '%')
+		{
+			continue;
+		}
+		if (*++c == '%')
+		{
+			continue;
+		}
+		c += strspn(c, "-+ #0");
+		c += strspn(c, "0123456789");
+		if (*c != 'd')
+		{
+			return -1;
+		}
+		++conversions;
+	}
+	return conversions == 1 ? 0 : -1;
+}
+
+/*
+ * Everything needed to write a document split into several files: the 
+ * serialized children of T_NEW_CATALOG and where each file starts.
+ */
+struct libcatner_split
+{
+	const char *pattern;	// File name pattern, see catner_write_xml_split()
+	const char *head;	// Everything up to the children of T_NEW_CATALOG
+	size_t head_len;	// Length of `head`
+	const char *tail;	// Everything after the children of T_NEW_CATALOG
+	size_t tail_len;	// Length of `tail`
+	const char **nodes;	// Serialized children of T_NEW_CATALOG
+	size_t *lens;		// Length of each serialized child
+	size_t *firsts;		// First child of each file, plus one past the end
+	size_t num_files;	// Number of files to write
+	int num_jobs;		// Number of threads writing files
+};
+
+typedef struct libcatner_split libcatner_split_s;
+
+/*
+ * Every `num_jobs`-th file of a split, starting with `first`.
+ */
+struct libcatner_split_job
+{
+	libcatner_split_s *split;	// What to write
+	size_t first;			// First file to write
+	int ret;			// 0 on success, -1 on error
+	pthread_t thread;		// Thread writing the files
+	int started;			// Whether `thread` was started
+};
+
+typedef struct libcatner_split_job libcatner_split_job_s;
+
+/*
+ * Thread function that writes the files of a split job, each consisting of 
+ * the head, its range of children of T_NEW_CATALOG and the tail.
+ */
+static void *libcatner_write_split(void *arg)
+{
+	libcatner_split_job_s *job = arg;
+	libcatner_split_s *split = job->split;
+
+	for (size_t f = job->first; f < split->num_files; f += split->num_jobs)
+	{
+		char path[PATH_MAX];
+		int len = snprintf(path, sizeof(path), split->pattern, (int) (f + 1));
+		FILE *fp = (len > 0 && len < PATH_MAX) ? fopen(path, "wb") : NULL;
+		if (fp == NULL)
+		{
+			job->ret = -1;
+			return NULL;
+		}
+
+		int ok = fwrite(split->head, 1, split->head_len, fp) == split->head_len;
+		for (size_t n = split->firsts[f]; ok && n < split->firsts[f + 1]; ++n)
+		{
+			ok = fwrite(split->nodes[n], 1, split->lens[n], fp) == split->lens[n];
+		}
+		ok = ok && fwrite(split->tail, 1, split->tail_len, fp) == split->tail_len;
+		ok = (fclose(fp) == 0) && ok;
+
+		if (!ok)
+		{
+			job->ret = -1;
+			return NULL;
+		}
+	}
+	job->ret = 0;
+	return NULL;
+}
+
+/*
+ * Decides which children of T_NEW_CATALOG go into which file, so that each 
+ * file has at most `max_articles` ARTICLE nodes and `max_bytes` bytes, 
+ * where 0 means no limit. Elements are never separated from the text or 
+ * comments that precede them. Fills in `split->firsts` and `num_files`. 
+ * Returns 0 on success, -1 if a single element exceeds `max_bytes`.
+ */
+static int libcatner_plan_split(catner_state_s *cs, libcatner_split_s *split, size_t num_nodes, 
+		size_t max_articles, size_t max_bytes)
+{
+	size_t fixed = split->head_len + split->tail_len;
+	size_t bytes = 0;
+	size_t articles = 0;
+
+	split->num_files = 0;
+	split->firsts[0] = 0;
+
+	xmlNodePtr node = cs->articles->children;
+	for (size_t n = 0; n < num_nodes; )
+	{
+		// A unit ends with the next element, or with the last node
+		size_t first = n;
+		size_t unit_bytes = 0;
+		size_t unit_articles = 0;
+		for (; n < num_nodes; ++n, node = node->next)
+		{
+			unit_bytes += split->lens[n];
+			if (node->type == XML_ELEMENT_NODE)
+			{
+				unit_articles = node->name == libcatner_name(node, LIBCATNER_NAME_ARTICLE);
+				++n;
+				node = node->next;
+				break;
+			}
+		}
+		if (unit_articles == 0 && n == num_nodes && first > 0)
+		{
+			// Trailing text or comments stay with the last element
+			if (max_bytes && fixed + bytes + unit_bytes > max_bytes)
+			{
+				return -1;
+			}
+			bytes += unit_bytes;
+			continue;
+		}
+
+		if (max_bytes && fixed + unit_bytes > max_bytes)
+		{
+			return -1;
+		}
+		if (first > split->firsts[split->num_files] && 
+				((max_articles && articles + unit_articles > max_articles) || 
+				 (max_bytes && fixed + bytes + unit_bytes > max_bytes)))
+		{
+			split->firsts[++split->num_files] = first;
+			bytes = 0;
+			articles = 0;
+		}
+		bytes += unit_bytes;
+		articles += unit_articles;
+	}
+
+	split->firsts[++split->num_files] = num_nodes;
+	return 0;
+}
+
+/*
+ * Creates a new ARTICLE node with the given ID (SUPPLIER_AID), title and 
+ * description, see catner_add_article(). In streaming mode, the articles 
+ * added before are written out first. Returns the new node or NULL on error.
+ */
+static xmlNodePtr libcatner_add_article(catner_state_s *cs, const char *aid, 
+		const char *title, const char *descr)
+{
+	if (xmlStrlen(BAD_CAST aid) == 0)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return NULL;
+	}
+
+	// Check if an article with the given AID already exists
+	if (libcatner_get_article(cs, BAD_CAST aid) != NULL)
+	{
+		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+		return NULL;
+	}
+
+	// In streaming mode, articles might have been written already
+	if (cs->_writer)
+	{
+		if (cs->_aid_written && xmlHashLookup(cs->_aid_written, BAD_CAST aid))
+		{
+			cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+			return NULL;
+		}
+
+		// The previous article is complete, write and discard it
+		if (libcatner_stream_flush(cs) != 0)
+		{
+			cs->error = LIBCATNER_ERR_OTHER;
+			return NULL;
+		}
+	}
+
+	// Create ARTICLE node with SUPPLIER_AID and ARTICLE_DETAILS child nodes
+	xmlNodePtr article = xmlNewChild(cs->articles, NULL, BMECAT_NODE_ARTICLE, NULL);
+	xmlNewTextChild(article, NULL, BMECAT_NODE_ARTICLE_ID, BAD_CAST aid);
+	xmlNodePtr details = xmlNewChild(article, NULL, BMECAT_NODE_ARTICLE_DETAILS, NULL);
+
+	// Possibly add DESCRIPTION_SHORT child node to ARTICLE_DETAILS
+	if (title != NULL)
+	{
+		xmlNewTextChild(details, NULL, BMECAT_NODE_ARTICLE_TITLE, BAD_CAST title);
+	}
+	// Possibly add DESCRIPTION_LONG child node to ARTICLE_DETAILS
+	if (descr != NULL)
+	{
+		xmlNewTextChild(details, NULL, BMECAT_NODE_ARTICLE_DESCR, BAD_CAST descr);
+	}
+
+	// Make the new article available for lookups by AID
+	if (xmlHashAddEntry(cs->_aid_index, BAD_CAST aid, article) != 0)
+	{
+		libcatner_del_node(article);
+		cs->error = LIBCATNER_ERR_OUT_OF_MEMORY;
+		return NULL;
+	}
+	++cs->_num_articles;
+
+	cs->_dirty = 1;
+	return article;
+}
+
+/*
+ * Adds an image to the given ARTICLE node, see catner_add_article_image().
+ * Returns 0 on success, -1 on error.
+ */
+static int libcatner_add_image(catner_state_s *cs, xmlNodePtr article, 
+		const char *mime, const char *path)
+{
+	// Find or create the MIME_INFO (image container) node for this article
+	xmlNodePtr images = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_IMAGES, 1);
+
+	// See if there is already an image with that path present
+	xmlNodePtr image = NULL;
+	for (image = images->children; image; image = image->next)
+	{
+		// Check if this MIME node has a MIME_SOURCE node with the given `path` value
+		if (libcatner_get_child(image, LIBCATNER_NAME_ARTICLE_IMAGE_PATH, BAD_CAST path, 0))
+		{
+			// If so, this image already exists, we're done
+			cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+			return -1;
+		}
+	}
+
+	// No such image present yet, let's create and return it
+	image = xmlNewChild(images, NULL, BMECAT_NODE_ARTICLE_IMAGE, NULL);
+	// TODO use xmlNewChild() or xmlNewTextChild()? 
+	xmlNewTextChild(image, NULL, BMECAT_NODE_ARTICLE_IMAGE_MIME, BAD_CAST mime);
+	xmlNewTextChild(image, NULL, BMECAT_NODE_ARTICLE_IMAGE_PATH, BAD_CAST path);
+
+	cs->_dirty = 1;
+	return 0;
+}
+
+/*
+ * Adds a unit to the given ARTICLE node, see catner_add_article_unit().
+ * Returns 0 on success, -1 on error.
+ */
+static int libcatner_add_unit(catner_state_s *cs, xmlNodePtr article, 
+		const char *code, const char *factor, int main)
+{
+	// Construct unit factor string based on user input and default value
+	const char *c = code   ? code   : LIBCATNER_DEF_UNIT_CODE;
+	const char *f = factor ? factor : LIBCATNER_DEF_UNIT_FACTOR;
+
+	// Find the ARTICLE_ORDER_DETAILS node, which holds all units
+	xmlNodePtr details = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_UNITS, 1);
+
+	// Iterate ARTICLE_ORDER_DETAILS' children to find ALTERNATIVE_UNIT nodes
+	xmlNodePtr alt_unit = NULL;
+	xmlNodePtr child = details->children;
+	for (child = details->children; child; child = child->next)
+	{
+		// We're only interested in ALTERNATIVE_UNIT nodes
+		if (child->name != libcatner_name(details, LIBCATNER_NAME_ARTICLE_ALT_UNIT))
+		{
+			continue;
+		}
+		
+		// Check if this ALTERNATIVE_UNIT has the unit code we're looking for
+		if (libcatner_get_child(child, LIBCATNER_NAME_ARTICLE_UNIT_CODE, BAD_CAST c, 0))
+		{
+			// If so, remember this node and stop iterating
+			alt_unit = child;
+			break;
+		}
+	}
+
+	xmlNodePtr main_unit = libcatner_get_child(details, LIBCATNER_NAME_ARTICLE_MAIN_UNIT, NULL, 0);
+
+	// No ORDER_UNIT (main unit) present yet, let's add it
+	if (main_unit == NULL)
+	{
+		main_unit = xmlNewTextChild(details, NULL, BMECAT_NODE_ARTICLE_MAIN_UNIT, BAD_CAST c);
+		cs->_dirty = 1;
+	}
+
+	// ORDER_UNIT (main unit) present; let's update the main unit, if so requested 
+	else if (main)
+	{
+		libcatner_set_content(main_unit, BAD_CAST c);
+	}
+
+	// ALTERNATIVE_UNIT node wasn't present for this unit code, we'll add it now
+	if (alt_unit == NULL)
+	{
+		alt_unit = xmlNewChild(details, NULL, BMECAT_NODE_ARTICLE_ALT_UNIT, NULL);
+		xmlNewTextChild(alt_unit, NULL, BMECAT_NODE_ARTICLE_UNIT_CODE,   BAD_CAST c);
+		xmlNewTextChild(alt_unit, NULL, BMECAT_NODE_ARTICLE_UNIT_FACTOR, BAD_CAST f);
+		cs->_dirty = 1;
+	}
+	
+	// ALTERNATIVE_UNIT was present, we'll just update it
+	else
+	{
+		xmlNodePtr unit_factor = libcatner_get_child(alt_unit, LIBCATNER_NAME_ARTICLE_UNIT_FACTOR, NULL, 0);
+		libcatner_set_content(unit_factor, BAD_CAST f);
+	}
+
+	return 0;
+}
+
+/*
+ * Adds a category to the given ARTICLE node, see catner_add_article_category().
+ * Returns 0 on success, -1 on error.
+ */
+static int libcatner_add_category(catner_state_s *cs, xmlNodePtr article, const char *value)
+{
+	xmlNodePtr child = NULL;
+	for (child = article->children; child; child = child->next)
+	{
+		// We are only interested in ARTICLE_REFERENCE nodes
+		if (child->name != libcatner_name(article, LIBCATNER_NAME_ARTICLE_CATEGORY))
+		{
+			continue;
+		}
+	
+		if (libcatner_get_child(child, LIBCATNER_NAME_ARTICLE_CATEGORY_ID, BAD_CAST value, 0))
+		{
+			// Already exists
+			cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+			return -1;
+		}
+	}
+
+	// No such category present yet, let's add it
+	xmlNodePtr cat = xmlNewChild(article, NULL, BMECAT_NODE_ARTICLE_CATEGORY, NULL);
+	xmlNewTextChild(cat, NULL, BMECAT_NODE_ARTICLE_CATEGORY_ID, BAD_CAST value);
+
+	cs->_dirty = 1;
+	return 0;
+}
+
+/*
+ * Adds a feature to the given ARTICLE node, see catner_add_feature().
+ * Returns the new FEATURE node or NULL on error.
+ */
+static xmlNodePtr libcatner_add_feature(catner_state_s *cs, xmlNodePtr article, const char *fid, 
+		const char *name, const char *descr, const char *unit, const char *value)
+{
+	// See if a FEATURE node with the given FID already exists
+	xmlNodePtr feature = libcatner_get_feature(article, BAD_CAST fid);
+	
+	// Feature already exists, we're done
+	if (feature != NULL)
+	{
+		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+		return NULL;
+	}
+
+	// Figure out the number of existing FEATUREs and make it a string
+	size_t num_features = libcatner_num_features(article);
+	char order[8];
+	snprintf(order, 8, "%zu", num_features + 1);
+
+	xmlNodePtr features = libcatner_get_container(article, LIBCATNER_NAME_FEATURES, 1);
+	feature = xmlNewChild(features, NULL, BMECAT_NODE_FEATURE, NULL);
+	xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_ID, BAD_CAST fid);
+	xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_ORDER, BAD_CAST order);
+
+	if (name)
+		xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_NAME,  BAD_CAST name);
+	
+	if (descr)
+		xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_DESCR, BAD_CAST descr);
+	
+	if (unit)
+		xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_UNIT,  BAD_CAST unit);
+	
+	if (value)
+		xmlNewTextChild(feature, NULL, BMECAT_NODE_FEATURE_VALUE, BAD_CAST value);
+
+	// Make the new feature available for lookups by FID
+	libcatner_index_feature(article, feature);
+	libcatner_count_features(article, 1);
+
+	cs->_dirty = 1;
+	return feature;
+}
+
+/*
+ * Adds a variant to the given FEATURE node, see catner_add_variant().
+ * Returns 0 on success, -1 on error.
+ */
+static int libcatner_add_variant(catner_state_s *cs, xmlNodePtr feature, 
+		const char *vid, const char *value)
+{
+	// Check if a VARIANT with the given VID already exists
+	if (libcatner_get_variant(feature, BAD_CAST vid) != NULL)
+	{
+		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+		return -1;
+	}
+
+	// Find or create VARIANTS node
+	xmlNodePtr variants = libcatner_get_child(feature, LIBCATNER_NAME_VARIANTS, NULL, 1);
+
+	// Features with variants should not have a FVALUE node themselves
+	xmlNodePtr fvalue = libcatner_get_child(feature, LIBCATNER_NAME_FEATURE_VALUE, NULL, 0);
+	if (fvalue)
+	{
+		// ... so if there is one, we'll remove it
+		libcatner_del_node(fvalue);
+	}
+	
+	// VARIANT does not yet exist, let's create it
+	xmlNodePtr variant = xmlNewChild(variants, NULL, BMECAT_NODE_VARIANT, NULL);
+	xmlNewTextChild(variant, NULL, BMECAT_NODE_VARIANT_ID,    BAD_CAST vid);
+	xmlNewTextChild(variant, NULL, BMECAT_NODE_VARIANT_VALUE, BAD_CAST value);
+
+	// Make the new variant available for lookups by VID
+	libcatner_index_variant(feature, variant);
+	libcatner_count_variants(feature, 1);
+
+	cs->_dirty = 1;
+	return 0;
+}
+
+/*
+ * Adds the article described by the given record, see catner_add_articles().
+ * If any part of it can't be added, the article is removed again, leaving the 
+ * document (and whether it has unsaved changes) as it was. Returns 0 on 
+ * success, -1 on error, with the error set accordingly.
+ */
+static int libcatner_add_record(catner_state_s *cs, const catner_article_rec_s *rec)
+{
+	int dirty = cs->_dirty;
+
+	xmlNodePtr article = libcatner_add_article(cs, rec->aid, rec->title, rec->descr);
+	if (article == NULL)
+	{
+		return -1;
+	}
+
+	int ret = 0;
+	for (size_t i = 0; ret == 0 && i < rec->num_features; ++i)
+	{
+		const catner_feature_rec_s *f = &rec->features[i];
+		xmlNodePtr feature = libcatner_add_feature(cs, article, f->fid, 
+				f->name, f->descr, f->unit, f->value);
+		if (feature == NULL)
+		{
+			ret = -1;
+			break;
+		}
+		for (size_t k = 0; ret == 0 && k < f->num_variants; ++k)
+		{
+			ret = libcatner_add_variant(cs, feature, f->variants[k].vid, f->variants[k].value);
+		}
+	}
+	for (size_t i = 0; ret == 0 && i < rec->num_units; ++i)
+	{
+		const catner_unit_rec_s *u = &rec->units[i];
+		ret = libcatner_add_unit(cs, article, u->code, u->factor, u->main);
+	}
+	for (size_t i = 0; ret == 0 && i < rec->num_images; ++i)
+	{
+		ret = libcatner_add_image(cs, article, rec->images[i].mime, rec->images[i].path);
+	}
+	for (size_t i = 0; ret == 0 && i < rec->num_categories; ++i)
+	{
+		ret = libcatner_add_category(cs, article, rec->categories[i]);
+	}
+
+	if (ret != 0)
+	{
+		// Remove what we've added so far, but keep the error
+		int error = cs->error;
+		libcatner_del_article(cs, article);
+		cs->error = error;
+		cs->_dirty = dirty;
+		return -1;
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//  PUBLIC API                                                               //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// ADD
+//
+
+/*
+ * Add the GENERATOR_INFO node and set it to the given `value`.
+ * If the node already exists, it will not be changed and -1 is returned.
+ * Otherwise, the node will be created and the function returns 0.
+ */
+int catner_add_generator(catner_state_s *cs, const char *value)
+{
+	if (cs->generator)
+	{
+		// Already exists
+		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+		return -1;
+	}
+
+	libcatner_add_child(cs->header, LIBCATNER_NAME_GENERATOR, BAD_CAST value);
+	return 0;
+}
+
+/*
+ * Add a TERRITORY with the given value.
+ * Returns 0 on success, -1 on error.
+ *
+ * TERRITORY nodes tell the processing software (the shop) what regions the 
+ * products in this BMEcat file can be shipped to. Examples: "DE", "AT".
+ * There can be multiple TERRITORY nodes, but each has to have a unique value.
+ *
+ * TODO - should we make sure `value` is uppercase?
+ *      - should we trim whitespace from `value`?
+ */
+int catner_add_territory(catner_state_s *cs, const char *value)
+{
+	// Valid TERRITORY values should be two uppercase ASCII letters
+	if (xmlStrlen(BAD_CAST value) != 2)
+	{
+		cs->error = LIBCATNER_ERR_INVALID_VALUE;
+		return -1;
+	}
+
+	// Find or create the TERRITORY node with the given value
+	xmlNodePtr t = libcatner_get_child(cs->catalog, LIBCATNER_NAME_TERRITORY, BAD_CAST value, 1);
+	
+	// Couldn't find nor create the TERRITORY node, no idea why
+	if (t == NULL)
+	{
+		cs->error = LIBCATNER_ERR_OTHER;
+		return -1;
+	}
+	
+	return 0;
+}
+
+/*
+ * Add a new article with the given ID (SUPPLIER_AID), title and description.
+ * If an article with the given ID already exists, this function returns -1.
+ * Otherwise, the article will be created and the function returns 0.
+ * On error (for example, aid is the empty string), -1 will be returned.
+ */
+int catner_add_article(catner_state_s *cs, const char *aid, const char *title, const char *descr)
+{
+	return libcatner_add_article(cs, aid, title, descr) ? 0 : -1;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_add_article_image(catner_state_s *cs, const char *aid, const char *mime, const char *path)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	return libcatner_add_image(cs, article, mime, path);
+}
+
+/*
+ * Adds a new alternative unit to the given article. If the article didn't have 
+ * a main unit set before, this unit will also be set as such. If the unit code 
+ * or factor aren't given, sensible defaults ("PCE" and "1") will be used. When 
+ * `main` is `1`, the current main unit (if any) will be updated with this one.
+ *
+ * TODO - it doesn't technically make much sense to have a main unit that has 
+ *        a factor other than "1" ("1.0", "1.00", ...), let's handle that
+ *      - we should consider taking the factor as a double, then converting it
+ *      - currently, calling this function with a unit CODE that already exists,
+ *        it will override the factor for that unit; instead, it should return 
+ *        -1 and set error to LIBCATNER_ERR_ALREADY_EXISTS; however, before we
+ *        change this, we should write catner_set_article_unit() so that there
+ *        is a way to update an existing unit...
+ */
+int catner_add_article_unit(catner_state_s *cs, const char *aid, 
+		const char *code, const char *factor, int main)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	return libcatner_add_unit(cs, article, code, factor, main);
+}
+
+/*
+ * Adds the given category ID to the article with the ID `aid` and returns 0.
+ * If there is no article with the given `aid` or if the article already has 
+ * the given category associated with it, this function returns -1.
+ */
+int catner_add_article_category(catner_state_s *cs, const char *aid, const char *value)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	return libcatner_add_category(cs, article, value);
+}
+
+/*
+ * TODO documentation
+ */
+int catner_add_feature(catner_state_s *cs, const char *aid, const char *fid, 
+		const char *name, const char *descr, const char *unit, const char *value)
+{
+	// Find the ARTICLE node with the given AID
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+	
+	// Article doesn't exist, that's an error
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	return libcatner_add_feature(cs, article, fid, name, descr, unit, value) ? 0 : -1;
+}
+
+/*
+ * TODO - add documentation
+ *      - is it a problem that catner_add_feature() will add the FORDER node?
+ */
+int catner_add_weight_feature(catner_state_s *cs, const char *aid, const char *value)
+{
+	return catner_add_feature(cs, aid, LIBCATNER_FEATURE_WEIGHT, 
+			LIBCATNER_FEATURE_WEIGHT, NULL, NULL, NULL);
+}
+
+/*
+ * TODO - documentation
+ */
+int catner_add_variant(catner_state_s *cs, const char *aid, 
+		const char *fid, const char *vid, const char *value)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+	
+	// Article doesn't exist, that's an error
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
+		cs->_curr_feature;
+
+	// Feature doesn't exist, that's an error
+	if (feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+		return -1;
+	}
+
+	return libcatner_add_variant(cs, feature, vid, value);
+}
+
+int catner_add_weight_variant(catner_state_s *cs, const char *aid, const char *vid, const char *value)
+{
+	return catner_add_variant(cs, aid, LIBCATNER_FEATURE_WEIGHT, vid, value);
+}
+
+/*
+ * Adds the articles described by the `num_recs` records in `recs`, each with 
+ * its features, variants, units, images and categories, in that order. This 
+ * does the same as the respective catner_add_*() calls, but looks up every 
+ * article only once and reuses the nodes just created. A record is added 
+ * either completely or not at all: if anything about it fails, the article 
+ * is removed again. If `status` is not NULL, it has to hold `num_recs` ints, 
+ * which receive LIBCATNER_ERR_NONE for every record that has been added and 
+ * the error otherwise, for example LIBCATNER_ERR_ALREADY_EXISTS if there 
+ * already is an article with the same AID (including earlier records). 
+ * Returns the number of records that have been added.
+ */
+size_t catner_add_articles(catner_state_s *cs, const catner_article_rec_s *recs, size_t num_recs, 
+		int *status)
+{
+	size_t added = 0;
+	for (size_t i = 0; i < num_recs; ++i)
+	{
+		int ret = libcatner_add_record(cs, &recs[i]);
+		if (status)
+		{
+			status[i] = ret == 0 ? LIBCATNER_ERR_NONE : cs->error;
+		}
+		added += (ret == 0);
+	}
+	return added;
+}
+
+//
+// SET
+// 
+
+/*
+ * Set the LOCALE to the given value, overwriting the existing value if any.
+ * If the node didn't exist yet, it will be created.
+ * Returns 0 on success, -1 on error.
+ *
+ * The LOCALE node tells the processing software (the shop) what language the 
+ * information in the file is in. Valid values are, for example, "EN" or "DE". 
+ * 
+ * TODO - should we make sure `value` is uppercase?
+ *      - should we trim whitespace from `value`?
+ */
+int catner_set_locale(catner_state_s *cs, const char *value)
+{
+	// Valid LOCALE values should be two uppercase ASCII letters
+	if (xmlStrlen(BAD_CAST value) != 2)
+	{
+		cs->error = LIBCATNER_ERR_INVALID_VALUE;
+		return -1;
+	}
+
+	libcatner_set_child(cs->catalog, LIBCATNER_NAME_LOCALE, BAD_CAST value, 1);
+	return 0;
+}
+
+/*
+ * Set the GENERATOR_INFO node to the given value. If the node didn't exist
+ * yet, it will be created.
+ *
+ * This node is optional and gives information on the software that 
+ * was used to generate the BMEcat file.
+ */
+int catner_set_generator(catner_state_s *cs, const char *value)
+{
+	if (cs->generator == NULL)
+	{
+		cs->generator = libcatner_add_child(cs->header, LIBCATNER_NAME_GENERATOR, BAD_CAST value);
+		return 0;
+	}
+
+	libcatner_set_content(cs->generator, BAD_CAST value);
+	return 0;
+}
+
+int catner_set_article_id(catner_state_s *cs, const char *aid, const char *value)
+{
+	if (xmlStrlen(BAD_CAST value) == 0)
+	{
+		cs->error = LIBCATNER_ERR_INVALID_VALUE;
+		return -1;
+	}
+
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	// Another article already uses the new AID
+	xmlNodePtr other = libcatner_get_article(cs, BAD_CAST value);
+	if (other != NULL && other != article)
+	{
+		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+		return -1;
+	}
+
+	xmlNodePtr id = libcatner_get_child(article, LIBCATNER_NAME_ARTICLE_ID, NULL, 0);
+	if (id == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	// Re-key the article in the AID index
+	libcatner_unindex_article(cs, article);
+	libcatner_set_content(id, BAD_CAST value);
+	libcatner_index_article(cs, article);
+	return 0;
+}
+
+/*
+ * Sets the title (DESCRIPTION_SHORT) of the article with the given AID. 
+ * Returns -1 if no matching article could be found, otherwise 0.
+ */
+int catner_set_article_title(catner_state_s *cs, const char *aid, const char *value)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	// Find or create the ARTICLE_DETAILS node within this ARTICLE
+	xmlNodePtr details = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_DETAILS, 1);
+
+	// Find or create the DESCRIPTION_SHORT node within ARTICLE_DETAILS
+	xmlNodePtr title = libcatner_get_child(details, LIBCATNER_NAME_ARTICLE_TITLE, NULL, 1);
+	
+	// Set the text of the title node accordingly
+	libcatner_set_content(title, BAD_CAST value);
+	return 0;
+}
+
+/*
+ * Sets the description (DESCRIPTION_LONG) of the article with the given AID. 
+ * Returns -1 if no matching article could be found, otherwise 0.
+ */
+int catner_set_article_descr(catner_state_s *cs, const char *aid, const char *value)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) 
+		: cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	// Find or create the ARTICLE_DETAILS node within this ARTICLE
+	xmlNodePtr details = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_DETAILS, 1);
+
+	// Find or create the DESCRIPTION_SHORT node within ARTICLE_DETAILS
+	xmlNodePtr descr = libcatner_get_child(details, LIBCATNER_NAME_ARTICLE_DESCR, NULL, 1);
+	
+	// Set the text of the title node accordingly
+	libcatner_set_content(descr, BAD_CAST value);
+	return 0;
+}
+
+static int catner_set_feature_prop(catner_state_s *cs, const char *aid, const char *fid, 
+		int prop, const char *value, int add)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) 
+		: cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
+		cs->_curr_feature;
+
+	if (feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+		return -1;
+	}
+
+	return libcatner_set_child(feature, prop, BAD_CAST value, add);
+}
+
+int catner_set_feature_id(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) 
+		: cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
+		cs->_curr_feature;
+
+	if (feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+		return -1;
+	}
+
+	// Another feature of this article already uses the new FID
+	xmlNodePtr other = libcatner_get_feature(article, BAD_CAST value);
+	if (other != NULL && other != feature)
+	{
+		cs->error = LIBCATNER_ERR_ALREADY_EXISTS;
+		return -1;
+	}
+
+	xmlNodePtr id = libcatner_get_child(feature, LIBCATNER_NAME_FEATURE_ID, NULL, 0);
+	if (id == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	// Re-key the feature in the article's FID index
+	libcatner_unindex_feature(article, feature);
+	libcatner_set_content(id, BAD_CAST value);
+	libcatner_index_feature(article, feature);
+	return 0;
+}
+
+int catner_set_feature_name(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+{
+	return catner_set_feature_prop(cs, aid, fid, LIBCATNER_NAME_FEATURE_NAME, value, 1);
+}
+
+int catner_set_feature_descr(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+{
+	return catner_set_feature_prop(cs, aid, fid, LIBCATNER_NAME_FEATURE_DESCR, value, 1);
+}
+
+// TODO there might not be a FVALUE element yet! If so, we have to create it
+int catner_set_feature_value(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+{
+	return catner_set_feature_prop(cs, aid, fid, LIBCATNER_NAME_FEATURE_VALUE, value, 1);
+}
+
+int catner_set_feature_unit(catner_state_s *cs, const char *aid, const char *fid, const char *value)
+{
+	const char *v = xmlStrlen(BAD_CAST value) ? value : LIBCATNER_DEF_FEATURE_UNIT;
+	return catner_set_feature_prop(cs, aid, fid, LIBCATNER_NAME_FEATURE_UNIT, v, 1);
+}
+
+int catner_set_variant_value(catner_state_s *cs, const char *aid, const char *fid, const char *vid, const char *value)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
+		cs->_curr_feature;
+
+	if (feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+		return -1;
+	}
+
+	xmlNodePtr variant = vid ? libcatner_get_variant(feature, BAD_CAST vid) : 
+		cs->_curr_variant;
+
+	if (variant == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_VID;
+		return -1;
+	}
+
+	return libcatner_set_child(variant, LIBCATNER_NAME_VARIANT_VALUE, BAD_CAST value, 0);
+}
+
+int catner_set_weight_variant(catner_state_s *cs, const char *aid, const char *vid, const char *value)
+{
+	return catner_set_variant_value(cs, aid, LIBCATNER_FEATURE_WEIGHT, vid, value);
+}
+
+//
+// GET
+//
+
+size_t catner_get_locale(catner_state_s *cs, char *buf, size_t len)
+{
+	xmlNodePtr locale = libcatner_get_child(cs->catalog, LIBCATNER_NAME_LOCALE, NULL, 0);
+	return libcatner_cpy_content(locale, buf, len);
+}
+
+size_t catner_get_generator(catner_state_s *cs, char *buf, size_t len)
+{
+	return libcatner_cpy_content(cs->generator, buf, len);
+}
+
+size_t catner_get_territories(catner_state_s *cs, char *buf, size_t len)
+{
+	xmlNodePtr t = libcatner_get_child(cs->catalog, LIBCATNER_NAME_TERRITORY, NULL, 0);
+	return libcatner_join_values(t, -1, buf, len);
+}
+
+size_t catner_get_article_aid(catner_state_s *cs, char *buf, size_t len)
+{
+	if (cs->_curr_article == NULL)
+	{
+		return libcatner_cpy_content(NULL, buf, len);
+	}
+
+	xmlNodePtr aid = libcatner_get_child(cs->_curr_article, LIBCATNER_NAME_ARTICLE_ID, NULL, 0);
+	return libcatner_cpy_content(aid, buf, len);
+}
+
+size_t catner_get_article_title(catner_state_s *cs, const char *aid, char *buf, size_t len)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return libcatner_cpy_content(NULL, buf, len);
+	}
+
+	xmlNodePtr title = libcatner_get_child(article, LIBCATNER_NAME_ARTICLE_TITLE, NULL, 0);
+	return libcatner_cpy_content(title, buf, len);
+}
+
+size_t catner_get_article_descr(catner_state_s *cs, const char *aid, char *buf, size_t len)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return libcatner_cpy_content(NULL, buf, len);
+	}
+
+	xmlNodePtr descr = libcatner_get_child(article, LIBCATNER_NAME_ARTICLE_DESCR, NULL, 0);
+	return libcatner_cpy_content(descr, buf, len);
+}
+
+/*
+ * Gets the article's _main_ unit
+ * TODO proper documentation
+ */
+size_t catner_get_article_unit(catner_state_s *cs, const char *aid, char *buf, size_t len)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return libcatner_cpy_content(NULL, buf, len);
+	}
+
+	xmlNodePtr units = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_UNITS, 0);
+
+	if (units == NULL)
+	{
+		return libcatner_cpy_content(NULL, buf, len);
+	}
+
+	xmlNodePtr munit = libcatner_get_child(units, LIBCATNER_NAME_ARTICLE_MAIN_UNIT, NULL, 0);
+	return libcatner_cpy_content(munit, buf, len);
+}
+
+size_t catner_get_article_categories(catner_state_s *cs, const char *aid, char *buf, size_t len)
+{
+	// Make sure buf passes as an empty, 0-terminated string
+	if (buf && len)
+	{
+		buf[0] = '\0';
+	}
+
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+	
+	if (article == NULL)
+	{
+		return 0;
+	}
+
+	xmlNodePtr cat = libcatner_get_child(article, LIBCATNER_NAME_ARTICLE_CATEGORY, NULL, 0);
+	return libcatner_join_values(cat, LIBCATNER_NAME_ARTICLE_CATEGORY_ID, buf, len);
+}
+
+size_t catner_get_sel_article_id(catner_state_s *cs, char *buf, size_t len)
+{
+	if (cs->_curr_article == NULL)
+	{
+		return libcatner_cpy_content(NULL, buf, len);
+	}
+
+	xmlNodePtr aid = libcatner_get_child(cs->_curr_article, LIBCATNER_NAME_ARTICLE_ID, NULL, 0);
+	return libcatner_cpy_content(aid, buf, len);
+}
+
+size_t catner_get_sel_feature_id(catner_state_s *cs, char *buf, size_t len)
+{
+	if (cs->_curr_feature == NULL)
+	{
+		return libcatner_cpy_content(NULL, buf, len);
+	}
+
+	xmlNodePtr fid = libcatner_get_child(cs->_curr_feature, LIBCATNER_NAME_FEATURE_ID, NULL, 0);
+	return libcatner_cpy_content(fid, buf, len);
+}
+
+size_t catner_get_sel_variant_id(catner_state_s *cs, char *buf, size_t len)
+{
+	if (cs->_curr_variant == NULL)
+	{
+		return libcatner_cpy_content(NULL, buf, len);
+	}
+
+	xmlNodePtr vid = libcatner_get_child(cs->_curr_variant, LIBCATNER_NAME_VARIANT_ID, NULL, 0);
+	return libcatner_cpy_content(vid, buf, len);
+}
+
+//
+// VIEW
+//
+
+/*
+ * The catner_view_*() functions point `view` at the text of the respective 
+ * node inside the document, without copying it. The text is not necessarily 
+ * null-terminated, use `view->len`. It stays valid until the node is changed 
+ * or deleted, or the state freed. As with the other functions, passing NULL 
+ * for `aid`, `fid` or `vid` means the selected article, feature or variant.
+ * Returns 0 on success, -1 on error, in which case `view` is emptied. Should 
+ * the content be split across several nodes, which libcatner never creates, 
+ * the error is LIBCATNER_ERR_OTHER and the catner_get_*() functions have to 
+ * be used instead.
+ */
+
+/*
+ * Views the AID (SUPPLIER_AID) of the given article.
+ */
+int catner_view_article_aid(catner_state_s *cs, const char *aid, catner_str_s *view)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		view->ptr = NULL;
+		view->len = 0;
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	return libcatner_view_child(cs, article, LIBCATNER_NAME_ARTICLE_ID, view);
+}
+
+/*
+ * Views the title (DESCRIPTION_SHORT) of the given article.
+ */
+int catner_view_article_title(catner_state_s *cs, const char *aid, catner_str_s *view)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		view->ptr = NULL;
+		view->len = 0;
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr details = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_DETAILS, 0);
+	return libcatner_view_child(cs, details, LIBCATNER_NAME_ARTICLE_TITLE, view);
+}
+
+/*
+ * Views the description (DESCRIPTION_LONG) of the given article.
+ */
+int catner_view_article_descr(catner_state_s *cs, const char *aid, catner_str_s *view)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		view->ptr = NULL;
+		view->len = 0;
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr details = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_DETAILS, 0);
+	return libcatner_view_child(cs, details, LIBCATNER_NAME_ARTICLE_DESCR, view);
+}
+
+/*
+ * Views the main unit (ORDER_UNIT) of the given article.
+ */
+int catner_view_article_unit(catner_state_s *cs, const char *aid, catner_str_s *view)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		view->ptr = NULL;
+		view->len = 0;
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr units = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_UNITS, 0);
+	return libcatner_view_child(cs, units, LIBCATNER_NAME_ARTICLE_MAIN_UNIT, view);
+}
+
+/*
+ * Views the child node with the given name of the given feature.
+ */
+static int libcatner_view_feature(catner_state_s *cs, const char *aid, const char *fid, 
+		int name, catner_str_s *view)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+
+	xmlNodePtr feature = NULL;
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+	}
+	else if ((feature = fid ? libcatner_get_feature(article, BAD_CAST fid) : 
+				cs->_curr_feature) == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+	}
+
+	if (feature == NULL)
+	{
+		view->ptr = NULL;
+		view->len = 0;
+		return -1;
+	}
+
+	return libcatner_view_child(cs, feature, name, view);
+}
+
+int catner_view_feature_id(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view)
+{
+	return libcatner_view_feature(cs, aid, fid, LIBCATNER_NAME_FEATURE_ID, view);
+}
+
+int catner_view_feature_name(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view)
+{
+	return libcatner_view_feature(cs, aid, fid, LIBCATNER_NAME_FEATURE_NAME, view);
+}
+
+int catner_view_feature_descr(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view)
+{
+	return libcatner_view_feature(cs, aid, fid, LIBCATNER_NAME_FEATURE_DESCR, view);
+}
+
+int catner_view_feature_unit(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view)
+{
+	return libcatner_view_feature(cs, aid, fid, LIBCATNER_NAME_FEATURE_UNIT, view);
+}
+
+int catner_view_feature_value(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view)
+{
+	return libcatner_view_feature(cs, aid, fid, LIBCATNER_NAME_FEATURE_VALUE, view);
+}
+
+/*
+ * Views the child node with the given name of the given variant.
+ */
+static int libcatner_view_variant(catner_state_s *cs, const char *aid, const char *fid, 
+		const char *vid, int name, catner_str_s *view)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) : 
+		cs->_curr_article;
+
+	xmlNodePtr feature = NULL;
+	xmlNodePtr variant = NULL;
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+	}
+	else if ((feature = fid ? libcatner_get_feature(article, BAD_CAST fid) : 
+				cs->_curr_feature) == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+	}
+	else if ((variant = vid ? libcatner_get_variant(feature, BAD_CAST vid) : 
+				cs->_curr_variant) == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_VID;
+	}
+
+	if (variant == NULL)
+	{
+		view->ptr = NULL;
+		view->len = 0;
+		return -1;
+	}
+
+	return libcatner_view_child(cs, variant, name, view);
+}
+
+int catner_view_variant_id(catner_state_s *cs, const char *aid, const char *fid, 
+		const char *vid, catner_str_s *view)
+{
+	return libcatner_view_variant(cs, aid, fid, vid, LIBCATNER_NAME_VARIANT_ID, view);
+}
+
+int catner_view_variant_value(catner_state_s *cs, const char *aid, const char *fid, 
+		const char *vid, catner_str_s *view)
+{
+	return libcatner_view_variant(cs, aid, fid, vid, LIBCATNER_NAME_VARIANT_VALUE, view);
+}
+
+/*
+ * Views the child node with the given name of the selected image.
+ */
+static int libcatner_view_sel_image(catner_state_s *cs, int name, catner_str_s *view)
+{
+	if (cs->_curr_image == NULL)
+	{
+		view->ptr = NULL;
+		view->len = 0;
+		cs->error = LIBCATNER_ERR_NO_SEL_IMAGE;
+		return -1;
+	}
+
+	return libcatner_view_child(cs, cs->_curr_image, name, view);
+}
+
+int catner_view_sel_image_mime(catner_state_s *cs, catner_str_s *view)
+{
+	return libcatner_view_sel_image(cs, LIBCATNER_NAME_ARTICLE_IMAGE_MIME, view);
+}
+
+int catner_view_sel_image_path(catner_state_s *cs, catner_str_s *view)
+{
+	return libcatner_view_sel_image(cs, LIBCATNER_NAME_ARTICLE_IMAGE_PATH, view);
+}
+
+/*
+ * Views the child node with the given name of the selected unit.
+ */
+static int libcatner_view_sel_unit(catner_state_s *cs, int name, catner_str_s *view)
+{
+	if (cs->_curr_unit == NULL)
+	{
+		view->ptr = NULL;
+		view->len = 0;
+		cs->error = LIBCATNER_ERR_NO_SEL_UNIT;
+		return -1;
+	}
+
+	return libcatner_view_child(cs, cs->_curr_unit, name, view);
+}
+
+int catner_view_sel_unit_code(catner_state_s *cs, catner_str_s *view)
+{
+	return libcatner_view_sel_unit(cs, LIBCATNER_NAME_ARTICLE_UNIT_CODE, view);
+}
+
+int catner_view_sel_unit_factor(catner_state_s *cs, catner_str_s *view)
+{
+	return libcatner_view_sel_unit(cs, LIBCATNER_NAME_ARTICLE_UNIT_FACTOR, view);
+}
+
+/*
+ * Fills `views` with up to `len` views of the values of all TERRITORY nodes, 
+ * see catner_view_article_aid() on views. Returns the number of territories, 
+ * which might be more than `len`; `views` may be NULL to just count them.
+ */
+size_t catner_view_territories(catner_state_s *cs, catner_str_s *views, size_t len)
+{
+	size_t num = 0;
+	xmlNodePtr t = libcatner_get_child(cs->catalog, LIBCATNER_NAME_TERRITORY, NULL, 0);
+	for (; t; t = libcatner_next_node(t), ++num)
+	{
+		if (num < len)
+		{
+			libcatner_view_text(t, &views[num]);
+		}
+	}
+	return num;
+}
+
+/*
+ * Fills `views` with up to `len` views of the category IDs of the given 
+ * article. Returns the number of categories, which might be more than `len`, 
+ * or 0 if the article doesn't exist. `views` may be NULL to just count them.
+ */
+size_t catner_view_article_categories(catner_state_s *cs, const char *aid, 
+		catner_str_s *views, size_t len)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return 0;
+	}
+
+	size_t num = 0;
+	xmlNodePtr cat = libcatner_get_child(article, LIBCATNER_NAME_ARTICLE_CATEGORY, NULL, 0);
+	for (; cat; cat = libcatner_next_node(cat))
+	{
+		xmlNodePtr id = libcatner_get_child(cat, LIBCATNER_NAME_ARTICLE_CATEGORY_ID, NULL, 0);
+		if (id == NULL)
+		{
+			continue;
+		}
+		if (num < len)
+		{
+			libcatner_view_text(id, &views[num]);
+		}
+		++num;
+	}
+	return num;
+}
+
+/*
+ * Fills `views` with up to `len` views of the codes and factors of the 
+ * alternative units of the given article. Returns the number of units, which 
+ * might be more than `len`, or 0 if the article doesn't exist. `views` may be 
+ * NULL to just count them.
+ */
+size_t catner_view_article_units(catner_state_s *cs, const char *aid, 
+		catner_unit_view_s *views, size_t len)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return 0;
+	}
+
+	xmlNodePtr units = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_UNITS, 0);
+	xmlNodePtr unit = units ? 
+		libcatner_get_child(units, LIBCATNER_NAME_ARTICLE_ALT_UNIT, NULL, 0) : NULL;
+
+	size_t num = 0;
+	for (; unit; unit = libcatner_next_node(unit), ++num)
+	{
+		if (num < len)
+		{
+			libcatner_view_text(libcatner_get_child(unit, 
+					LIBCATNER_NAME_ARTICLE_UNIT_CODE, NULL, 0), &views[num].code);
+			libcatner_view_text(libcatner_get_child(unit, 
+					LIBCATNER_NAME_ARTICLE_UNIT_FACTOR, NULL, 0), &views[num].factor);
+		}
+	}
+	return num;
+}
+
+/*
+ * Fills `views` with up to `len` views of the MIME types and paths of the 
+ * images of the given article. Returns the number of images, which might be 
+ * more than `len`, or 0 if the article doesn't exist. `views` may be NULL to 
+ * just count them.
+ */
+size_t catner_view_article_images(catner_state_s *cs, const char *aid, 
+		catner_image_view_s *views, size_t len)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return 0;
+	}
+
+	xmlNodePtr images = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_IMAGES, 0);
+	xmlNodePtr image = images ? 
+		libcatner_get_child(images, LIBCATNER_NAME_ARTICLE_IMAGE, NULL, 0) : NULL;
+
+	size_t num = 0;
+	for (; image; image = libcatner_next_node(image), ++num)
+	{
+		if (num < len)
+		{
+			libcatner_view_text(libcatner_get_child(image, 
+					LIBCATNER_NAME_ARTICLE_IMAGE_MIME, NULL, 0), &views[num].mime);
+			libcatner_view_text(libcatner_get_child(image, 
+					LIBCATNER_NAME_ARTICLE_IMAGE_PATH, NULL, 0), &views[num].path);
+		}
+	}
+	return num;
+}
+
+//
+// DEL
+// 
+
+/*
+ * TODO documentation
+ */
+int catner_del_generator(catner_state_s *cs)
+{
+	libcatner_del_node(cs->generator);
+	cs->generator = NULL;
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_del_territory(catner_state_s *cs, const char *value)
+{
+	xmlNodePtr territory = libcatner_get_child(cs->catalog, LIBCATNER_NAME_TERRITORY, BAD_CAST value, 0);
+	if (territory == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	libcatner_del_node(territory);
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_del_article(catner_state_s *cs, const char *aid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	libcatner_del_article(cs, article);
+	return 0;
+}
+
+/*
+ * Deletes all articles whose AID is in the given array of `num_aids` AIDs. 
+ * AIDs that don't belong to any article are skipped. Each article is found 
+ * via the AID index, so this takes time proportional to `num_aids`, not to 
+ * the number of articles in the document. If the selected article is among 
+ * the deleted ones, the selection is reset. Returns the number of deleted 
+ * articles.
+ */
+size_t catner_del_articles(catner_state_s *cs, const char **aids, size_t num_aids)
+{
+	size_t deleted = 0;
+	for (size_t i = 0; i < num_aids; ++i)
+	{
+		xmlNodePtr article = aids[i] ? libcatner_get_article(cs, BAD_CAST aids[i]) : NULL;
+		if (article)
+		{
+			libcatner_del_article(cs, article);
+			++deleted;
+		}
+	}
+	return deleted;
+}
+
+/*
+ * Deletes all articles for whose AID `filter` returns a non-zero value, in 
+ * one pass over T_NEW_CATALOG. `data` is handed to the filter as is, the AID 
+ * is NULL for articles that don't have one. The filter must not change the 
+ * document. If the selected article is among the 
+ * deleted ones, the selection is reset. Returns the number of deleted 
+ * articles.
+ */
+size_t catner_del_articles_if(catner_state_s *cs, catner_aid_filter filter, void *data)
+{
+	size_t deleted = 0;
+	xmlNodePtr article = libcatner_get_child(cs->articles, LIBCATNER_NAME_ARTICLE, NULL, 0);
+	while (article)
+	{
+		xmlNodePtr next = libcatner_next_node(article);
+
+		// Only copy the AID if we can't use it in place
+		xmlNodePtr id = libcatner_get_child(article, LIBCATNER_NAME_ARTICLE_ID, NULL, 0);
+		const xmlChar *aid = id ? libcatner_get_text(id) : NULL;
+		xmlChar *copy = (id && aid == NULL) ? xmlNodeGetContent(id) : NULL;
+
+		if (filter(aid ? (const char *) aid : (const char *) copy, data))
+		{
+			libcatner_del_article(cs, article);
+			++deleted;
+		}
+
+		xmlFree(copy);
+		article = next;
+	}
+	return deleted;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_del_article_category(catner_state_s *cs, const char *aid, const char *cid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr cat = libcatner_get_child(article, LIBCATNER_NAME_ARTICLE_CATEGORY, NULL, 0);
+
+	for (; cat; cat = libcatner_next_node(cat))
+	{
+		xmlNodePtr cat_id = libcatner_get_child(cat, LIBCATNER_NAME_ARTICLE_CATEGORY_ID, BAD_CAST cid, 0);
+		if (cat_id == NULL)
+		{
+			continue;
+		}
+
+		libcatner_del_node(cat);
+		return 0;
+	}
+	cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+	return -1;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_del_article_image(catner_state_s *cs, const char *aid, const char *path)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr images = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_IMAGES, 0);
+
+	if (images == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	xmlNodePtr image = libcatner_get_child(images, LIBCATNER_NAME_ARTICLE_IMAGE_PATH, BAD_CAST path, 0);
+
+	// Are we about to delete the currently selected image?
+	if (cs->_curr_image == image)
+	{
+		cs->_curr_image = NULL;
+	}
+
+	libcatner_del_node(image);
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_del_feature(catner_state_s *cs, const char *aid, 
+		const char *fid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
+		cs->_curr_feature;
+
+	if (feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+		return -1;
+	}
+
+	// Are we about to delete the currently selected feature?
+	if (cs->_curr_feature == feature)
+	{
+		cs->_curr_feature = NULL;
+		cs->_curr_variant = NULL;
+	}
+
+	// Remove the feature from the article's FID index before it is gone
+	libcatner_unindex_feature(article, feature);
+	libcatner_count_features(article, -1);
+	libcatner_free_feature_meta(feature);
+
+	libcatner_del_node(feature);
+	libcatner_fix_feature_order(article);
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_del_weight_feature(catner_state_s *cs, const char *aid)
+{
+	return catner_del_feature(cs, aid, LIBCATNER_FEATURE_WEIGHT);
+}
+
+/*
+ * TODO documentation
+ */
+int catner_del_variant(catner_state_s *cs, const char *aid, 
+		const char *fid, const char *vid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
+		return -1;
+	}
+
+	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
+		cs->_curr_feature;
+
+	if (feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+		return -1;
+	}
+
+	xmlNodePtr variant = vid ? libcatner_get_variant(feature, BAD_CAST vid) : 
+		cs->_curr_variant;
+
+	if (variant == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_VID;
+		return -1;
+	}
+
+	// Are we about to delete the currently selected variant?
+	if (cs->_curr_variant == variant)
+	{
+		cs->_curr_variant = NULL;
+	}
+
+	// Remove the variant from the feature's VID index before it is gone
+	libcatner_unindex_variant(feature, variant);
+	libcatner_count_variants(feature, -1);
+
+	libcatner_del_node(variant);
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_del_weight_variant(catner_state_s *cs, const char *aid, const char *vid)
+{
+	return catner_del_variant(cs, aid, LIBCATNER_FEATURE_WEIGHT, vid);
+}
+
+//
+// NUM
+//
+
+size_t catner_num_territories(catner_state_s *cs)
+{
+	return libcatner_num_children(cs->catalog, LIBCATNER_NAME_TERRITORY, NULL);
+}
+
+size_t catner_num_articles(catner_state_s *cs)
+{
+	return cs->_num_articles;
+}
+
+size_t catner_num_article_categories(catner_state_s *cs, const char *aid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return 0;
+	}
+
+	return libcatner_num_children(article, LIBCATNER_NAME_ARTICLE_CATEGORY, NULL);
+}
+
+size_t catner_num_article_images(catner_state_s *cs, const char *aid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return 0;
+	}
+
+	xmlNodePtr images = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_IMAGES, 0);
+
+	if (images == NULL)
+	{
+		return 0;
+	}
+
+	return libcatner_num_children(images, LIBCATNER_NAME_ARTICLE_IMAGE, NULL);
+}
+
+size_t catner_num_article_units(catner_state_s *cs, const char *aid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return 0;
+	}
+
+	xmlNodePtr units = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_UNITS, 0);
+
+	if (units == NULL)
+	{
+		return 0;
+	}
+
+	return libcatner_num_children(units, LIBCATNER_NAME_ARTICLE_ALT_UNIT, NULL);
+}
+
+size_t catner_num_features(catner_state_s *cs, const char *aid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return 0;
+	}
+
+	return libcatner_num_features(article);
+}
+
+size_t catner_num_variants(catner_state_s *cs, const char *aid, const char *fid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return 0;
+	}
+
+	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
+		cs->_curr_feature;
+
+	if (feature == NULL)
+	{
+		return 0;
+	}
+
+	return libcatner_num_variants(feature);
+}
+
+//
+// HAS
+// 
+
+int catner_has_article_title(catner_state_s *cs, const char *aid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return 0;
+	}
+
+	xmlNodePtr details = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_DETAILS, 0);
+	
+	if (details == NULL)
+	{
+		return 0;
+	}
+
+	return libcatner_has_child(details, LIBCATNER_NAME_ARTICLE_TITLE, 0);
+}
+
+int catner_has_article_descr(catner_state_s *cs, const char *aid)
+{
+	xmlNodePtr article = aid ? libcatner_get_article(cs, BAD_CAST aid) :
+		cs->_curr_article;
+
+	if (article == NULL)
+	{
+		return 0;
+	}
+
+	xmlNodePtr details = libcatner_get_container(article, LIBCATNER_NAME_ARTICLE_DETAILS, 0);
+	
+	if (details == NULL)
+	{
+		return 0;
+	}
+
+	return libcatner_has_child(details, LIBCATNER_NAME_ARTICLE_DESCR, 0);
+}
+
+int catner_has_article_images(catner_state_s *cs, const char *aid)
+{
+	return catner_num_article_images(cs, aid) > 0;
+}
+
+int catner_has_article_categories(catner_state_s *cs, const char *aid)
+{
+	return catner_num_article_categories(cs, aid) > 0;
+}
+
+//
+// SEL
+//
+
+/*
+ * Set the currently selected article to the one identified by the given
+ * `aid`. If the article was found, it will be selected and 0 is returned.
+ * Otherwise, the selected article will not be changed and -1 is returned.
+ */
+int catner_sel_article(catner_state_s *cs, const char *aid)
+{
+	xmlNodePtr article = libcatner_get_article(cs, BAD_CAST aid);
+	if (article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	
+	// Check if this is different from the currently selected article
+	if (cs->_curr_article != article)
+	{
+		// If so, update the reference
+		cs->_curr_article = article;
+
+		// We also have to reset feature and variant selection
+		cs->_curr_feature = NULL;
+		cs->_curr_variant = NULL;
+		cs->_curr_image   = NULL;
+		cs->_curr_unit    = NULL;
+	}
+
+	return 0;
+}
+
+/*
+ * Set the currently selected article to the first article there is, or NULL 
+ * if there is none. If the first article was already selected, this function 
+ * does nothing. Otherwise, the current feature and variant selection will be 
+ * reset to NULL. Returns 0 if there is now an article selected, otherwise -1.
+ */
+int catner_sel_first_article(catner_state_s *cs)
+{
+	// Let's find the first article
+	xmlNodePtr first = libcatner_get_child(cs->articles, LIBCATNER_NAME_ARTICLE, NULL, 0);
+	
+	// Check if this is different from the currently selected article
+	if (cs->_curr_article != first)
+	{
+		// If so, update the reference
+		cs->_curr_article = first;
+
+		// We also have to reset feature and variant selection
+		cs->_curr_feature = NULL;
+		cs->_curr_variant = NULL;
+		cs->_curr_image   = NULL;
+		cs->_curr_unit    = NULL;
+	}
+
+	if (cs->_curr_article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Change the currently selected article to the next one there is, or NULL.
+ * If no article was selected, this function will do nothing and return 0.
+ * Otherwise, the currently selected feature and variant will be reset, too.
+ * Returns 0 if there was another article and it was selected, otherwise -1.
+ */
+int catner_sel_next_article(catner_state_s *cs)
+{
+	// If we have no article currently selected, abort
+	if (cs->_curr_article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
+		return -1;
+	}
+
+	// Now we'll advance to the next article
+	cs->_curr_article = libcatner_next_node(cs->_curr_article);
+	
+	// Change of article means we've got to reset selected feature and variant
+	cs->_curr_feature = NULL;
+	cs->_curr_variant = NULL;
+	cs->_curr_image   = NULL;
+	cs->_curr_unit    = NULL;
+
+	if (cs->_curr_article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	return 0;
+}
+
+int catner_sel_feature(catner_state_s *cs, const char *fid)
+{
+	// Can't select a feature if no article selected
+	if (cs->_curr_article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
+		return -1;
+	}
+
+	xmlNodePtr feature = libcatner_get_feature(cs->_curr_article, BAD_CAST fid);
+
+	if (feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	// The selected feature has changed?
+	if (cs->_curr_feature != feature)
+	{
+		// Update the feature selection
+		cs->_curr_feature = feature;
+
+		// Therefore, also reset the current variant selection
+		cs->_curr_variant = NULL;
+	}
+
+	return 0;
+}
+
+/*
+ * Set the currently selected feature to the first one of the currently 
+ * selected article, if any. If the first feature was already selected before, 
+ * this function does nothing and returns 1. If the selection was changed, 
+ * the current variant selection will be reset and the function returns 1 if 
+ * there is now a feature selected or 0 if no feature could be selected. 
+ */
+int catner_sel_first_feature(catner_state_s *cs)
+{
+	// Can't select a feature if no article selected
+	if (cs->_curr_article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
+		return -1;
+	}
+	
+	// Find the node containing all features 
+	xmlNodePtr features = libcatner_get_container(cs->_curr_article, LIBCATNER_NAME_FEATURES, 0);
+	if (features == NULL)
+	{
+		// The selected article doesn't have any features
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	// Find the first feature or NULL if there aren't any
+	xmlNodePtr first = libcatner_get_child(features, LIBCATNER_NAME_FEATURE, NULL, 0);
+
+	// The selected feature has changed?
+	if (cs->_curr_feature != first)
+	{
+		// Update the feature selection
+		cs->_curr_feature = first;
+
+		// Therefore, also reset the current variant selection
+		cs->_curr_variant = NULL;
+	}
+
+	if (cs->_curr_feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_sel_next_feature(catner_state_s *cs)
+{
+	// Make sure we currently have a feature selected, otherwise abort
+	if (cs->_curr_feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_FEATURE;
+		return -1;
+	}
+
+	// Now we'll advance to the next feature
+	cs->_curr_feature = libcatner_next_node(cs->_curr_feature);
+
+	// Change of feature means we've to to reset the selected variant
+	cs->_curr_variant = NULL;
+
+	if (cs->_curr_feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;	
+	}
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_sel_first_variant(catner_state_s *cs)
+{
+	// Check if we have a feature selected, otherwise abort
+	if (cs->_curr_feature == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_FEATURE;
+		return -1;
+	}
+
+	// Find the node containing all variants of this feature
+	xmlNodePtr variants = libcatner_get_child(cs->_curr_feature, LIBCATNER_NAME_VARIANTS, NULL, 0);
+	if (variants == NULL)
+	{
+		// The selected feature doesn't have any variants
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	// Find the first variant
+	cs->_curr_variant = libcatner_get_child(variants, LIBCATNER_NAME_VARIANT, NULL, 0);
+		
+	if (cs->_curr_variant == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_sel_next_variant(catner_state_s *cs)
+{
+	// Abort right away if we don't currently have a variant selected
+	if (cs->_curr_variant == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_VARIANT;
+		return -1;
+	}
+
+	// Now we'll advance to the next variant
+	cs->_curr_variant = libcatner_next_node(cs->_curr_variant);
+
+	if (cs->_curr_variant == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_sel_first_image(catner_state_s *cs)
+{
+	// Abort if no article selected
+	if (cs->_curr_article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
+		return -1;
+	}
+
+	// Get the MIME_INFO node that contains all images
+	xmlNodePtr images = libcatner_get_container(cs->_curr_article, LIBCATNER_NAME_ARTICLE_IMAGES, 0);
+	if (images == NULL)
+	{
+		// The selected article doesn't have any images
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	// Find the first image
+	cs->_curr_image = libcatner_get_child(images, LIBCATNER_NAME_ARTICLE_IMAGE, NULL, 0);
+
+	if (cs->_curr_image == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_sel_next_image(catner_state_s *cs)
+{
+	// Abort if not currently any image selected
+	if (cs->_curr_image == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_IMAGE;
+		return -1;
+	}
+
+	// Now we'll advance to the next image
+	cs->_curr_image = libcatner_next_node(cs->_curr_image);
+
+	if (cs->_curr_image == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_sel_first_unit(catner_state_s *cs)
+{
+	// Abort if no article selected
+	if (cs->_curr_article == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
+		return -1;
+	}
+
+	// Get the ARTICLE_ORDER_DETAILS node that contains all (alternative) units
+	xmlNodePtr units = libcatner_get_container(cs->_curr_article, LIBCATNER_NAME_ARTICLE_UNITS, 0);
+	if (units == NULL)
+	{
+		// No units, we're done
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	// Find the first unit
+	cs->_curr_unit = libcatner_get_child(units, LIBCATNER_NAME_ARTICLE_ALT_UNIT, NULL, 0);
+	
+	if (cs->_curr_unit == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * TODO documentation
+ */
+int catner_sel_next_unit(catner_state_s *cs)
+{
+	// Abort if no unit selected
+	if (cs->_curr_unit == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SEL_UNIT;
+		return -1;
+	}
+
+	// Get the next unit node, if there is one
+	cs->_curr_unit = libcatner_next_node(cs->_curr_unit);
+
+	if (cs->_curr_unit == NULL)
 	{
-		return libcatner_cpy_content(NULL, buf, len);
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
 	}
-
-	xmlNodePtr aid = libcatner_get_child(cs->_curr_article, BMECAT_NODE_ARTICLE_ID, NULL, 0);
-	return libcatner_cpy_content(aid, buf, len);
+	return 0;
 }
 
-size_t catner_get_sel_feature_id(catner_state_s *cs, char *buf, size_t len)
-{
-	if (cs->_curr_feature == NULL)
-	{
-		return libcatner_cpy_content(NULL, buf, len);
-	}
+//
+// ITER
+//
 
-	xmlNodePtr fid = libcatner_get_child(cs->_curr_feature, BMECAT_NODE_FEATURE_ID, NULL, 0);
-	return libcatner_cpy_content(fid, buf, len);
+/*
+ * Iterators walk articles, features, variants, images or units on their own, 
+ * without using or changing the selection. They are plain structs that can 
+ * be copied freely, and a range of them can be split with catner_iter_split() 
+ * to be walked by several threads at once. For that to be safe, iterators 
+ * only ever read the document: they don't build indexes and don't set the 
+ * state's error, and the document must not be changed while they're in use.
+ * Iterators of a kind have to be passed to functions for that kind only.
+ */
+
+/*
+ * Points `it` at the first of the given parent's children with the given 
+ * name, to iterate all of them. Returns 0 if there is one, otherwise -1.
+ */
+static int libcatner_iter_children(xmlNodePtr parent, int name, catner_iter_s *it)
+{
+	it->node = parent ? libcatner_get_child(parent, name, NULL, 0) : NULL;
+	it->end  = NULL;
+	return it->node ? 0 : -1;
 }
 
-size_t catner_get_sel_variant_id(catner_state_s *cs, char *buf, size_t len)
+/*
+ * Views the content of the child node with the given name of the iterator's 
+ * current node. If `container` isn't -1, that child is looked for within the 
+ * current node's child of that name instead. Returns 0 on success, else -1.
+ */
+static int libcatner_iter_view(const catner_iter_s *it, int container, int name, 
+		catner_str_s *view)
 {
-	if (cs->_curr_variant == NULL)
+	xmlNodePtr parent = it->node;
+	if (parent && container != -1)
 	{
-		return libcatner_cpy_content(NULL, buf, len);
+		parent = libcatner_get_child(parent, container, NULL, 0);
 	}
 
-	xmlNodePtr vid = libcatner_get_child(cs->_curr_variant, BMECAT_NODE_VARIANT_ID, NULL, 0);
-	return libcatner_cpy_content(vid, buf, len);
+	xmlNodePtr child = parent ? libcatner_get_child(parent, name, NULL, 0) : NULL;
+	libcatner_view_text(child, view);
+	return view->ptr ? 0 : -1;
 }
 
-//
-// DEL
-// 
+/*
+ * Points `it` at the first article. Returns 0 on success, -1 if there are 
+ * no articles.
+ */
+int catner_iter_articles(catner_state_s *cs, catner_iter_s *it)
+{
+	return libcatner_iter_children(cs->articles, LIBCATNER_NAME_ARTICLE, it);
+}
 
 /*
- * TODO documentation
+ * Points `it` at the first feature of the article `article` is at. 
+ * Returns 0 on success, -1 if the article has no features.
  */
-int catner_del_generator(catner_state_s *cs)
+int catner_iter_features(const catner_iter_s *article, catner_iter_s *it)
 {
-	libcatner_del_node(cs->generator);
-	return 0;
+	xmlNodePtr features = article->node ? 
+		libcatner_get_child(article->node, LIBCATNER_NAME_FEATURES, NULL, 0) : NULL;
+	return libcatner_iter_children(features, LIBCATNER_NAME_FEATURE, it);
 }
 
 /*
- * TODO documentation
+ * Points `it` at the first variant of the feature `feature` is at. 
+ * Returns 0 on success, -1 if the feature has no variants.
  */
-int catner_del_territory(catner_state_s *cs, const char *value)
+int catner_iter_variants(const catner_iter_s *feature, catner_iter_s *it)
 {
-	xmlNodePtr territory = libcatner_get_child(cs->catalog, BMECAT_NODE_TERRITORY, BAD_CAST value, 0);
-	if (territory == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
-	}
+	xmlNodePtr variants = feature->node ? 
+		libcatner_get_child(feature->node, LIBCATNER_NAME_VARIANTS, NULL, 0) : NULL;
+	return libcatner_iter_children(variants, LIBCATNER_NAME_VARIANT, it);
+}
 
-	libcatner_del_node(territory);
-	return 0;
+/*
+ * Points `it` at the first image of the article `article` is at. 
+ * Returns 0 on success, -1 if the article has no images.
+ */
+int catner_iter_images(const catner_iter_s *article, catner_iter_s *it)
+{
+	xmlNodePtr images = article->node ? 
+		libcatner_get_child(article->node, LIBCATNER_NAME_ARTICLE_IMAGES, NULL, 0) : NULL;
+	return libcatner_iter_children(images, LIBCATNER_NAME_ARTICLE_IMAGE, it);
 }
 
 /*
- * TODO documentation
+ * Points `it` at the first (alternative) unit of the article `article` is at. 
+ * Returns 0 on success, -1 if the article has no units.
  */
-int catner_del_article(catner_state_s *cs, const char *aid)
+int catner_iter_units(const catner_iter_s *article, catner_iter_s *it)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	xmlNodePtr units = article->node ? 
+		libcatner_get_child(article->node, LIBCATNER_NAME_ARTICLE_UNITS, NULL, 0) : NULL;
+	return libcatner_iter_children(units, LIBCATNER_NAME_ARTICLE_ALT_UNIT, it);
+}
 
-	if (article == NULL)
+/*
+ * Advances the iterator to the next element of its kind. Returns 0 on 
+ * success, -1 if the end of the iterator's range has been reached.
+ */
+int catner_iter_next(catner_iter_s *it)
+{
+	if (it->node)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		it->node = libcatner_next_node(it->node);
 	}
-
-	// Are we about to delete the currently selected article?
-	if (cs->_curr_article == article)
+	if (it->node == it->end)
 	{
-		cs->_curr_article = NULL;
-		cs->_curr_feature = NULL;
-		cs->_curr_variant = NULL;
-		cs->_curr_image   = NULL;
+		it->node = NULL;
 	}
-
-	libcatner_del_node(article);
-	return 0;
+	return it->node ? 0 : -1;
 }
 
 /*
- * TODO documentation
+ * Splits what is left of the given iterator's range, including its current 
+ * element, into up to `num` consecutive ranges of (almost) the same number of 
+ * elements, which are stored in `ranges`. Each of them can then be walked 
+ * with catner_iter_next() independently, for example by its own thread. 
+ * This has to count the elements once. Returns the number of ranges, which 
+ * is less than `num` if there are fewer elements than that.
  */
-int catner_del_article_category(catner_state_s *cs, const char *aid, const char *cid)
+size_t catner_iter_split(const catner_iter_s *it, catner_iter_s *ranges, size_t num)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
-
-	if (article == NULL)
+	catner_iter_s curr = *it;
+	size_t num_nodes = 0;
+	for (; curr.node; catner_iter_next(&curr))
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		++num_nodes;
 	}
 
-	xmlNodePtr cat = libcatner_get_child(article, BMECAT_NODE_ARTICLE_CATEGORY, NULL, 0);
+	if (num > num_nodes)
+	{
+		num = num_nodes;
+	}
 
-	for (; cat; cat = libcatner_next_node(cat))
+	curr = *it;
+	for (size_t i = 0; i < num; ++i)
 	{
-		xmlNodePtr cat_id = libcatner_get_child(cat, BMECAT_NODE_ARTICLE_CATEGORY_ID, BAD_CAST cid, 0);
-		if (cat_id == NULL)
+		ranges[i].node = curr.node;
+
+		size_t range_len = num_nodes / num + (i < num_nodes % num);
+		for (size_t n = 0; n < range_len; ++n)
 		{
-			continue;
+			catner_iter_next(&curr);
 		}
-
-		libcatner_del_node(cat);
-		return 0;
+		ranges[i].end = curr.node ? curr.node : it->end;
 	}
-	cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-	return -1;
+	return num;
 }
 
-/*
- * TODO documentation
- */
-int catner_del_article_image(catner_state_s *cs, const char *aid, const char *path)
+int catner_iter_article_aid(const catner_iter_s *it, catner_str_s *view)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_ARTICLE_ID, view);
+}
 
-	if (article == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
-	}
+int catner_iter_article_title(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, LIBCATNER_NAME_ARTICLE_DETAILS, LIBCATNER_NAME_ARTICLE_TITLE, view);
+}
 
-	xmlNodePtr images = libcatner_get_child(article, BMECAT_NODE_ARTICLE_IMAGES, NULL, 0);
+int catner_iter_article_descr(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, LIBCATNER_NAME_ARTICLE_DETAILS, LIBCATNER_NAME_ARTICLE_DESCR, view);
+}
 
-	if (images == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
-	}
+int catner_iter_article_unit(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, LIBCATNER_NAME_ARTICLE_UNITS, LIBCATNER_NAME_ARTICLE_MAIN_UNIT, view);
+}
 
-	xmlNodePtr image = libcatner_get_child(images, BMECAT_NODE_ARTICLE_IMAGE_PATH, BAD_CAST path, 0);
+int catner_iter_feature_id(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_FEATURE_ID, view);
+}
 
-	// Are we about to delete the currently selected image?
-	if (cs->_curr_image == image)
-	{
-		cs->_curr_image = NULL;
-	}
+int catner_iter_feature_name(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_FEATURE_NAME, view);
+}
 
-	libcatner_del_node(image);
-	return 0;
+int catner_iter_feature_descr(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_FEATURE_DESCR, view);
 }
 
-/*
- * TODO documentation
- */
-int catner_del_feature(catner_state_s *cs, const char *aid, 
-		const char *fid)
+int catner_iter_feature_unit(const catner_iter_s *it, catner_str_s *view)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_FEATURE_UNIT, view);
+}
 
-	if (article == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
-	}
+int catner_iter_feature_value(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_FEATURE_VALUE, view);
+}
 
-	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
-		cs->_curr_feature;
+int catner_iter_variant_id(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_VARIANT_ID, view);
+}
 
-	if (feature == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
-		return -1;
-	}
+int catner_iter_variant_value(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_VARIANT_VALUE, view);
+}
 
-	// Are we about to delete the currently selected feature?
-	if (cs->_curr_feature == feature)
-	{
-		cs->_curr_feature = NULL;
-		cs->_curr_variant = NULL;
-	}
+int catner_iter_image_mime(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_ARTICLE_IMAGE_MIME, view);
+}
 
-	libcatner_del_node(feature);
-	libcatner_fix_feature_order(article);
-	return 0;
+int catner_iter_image_path(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_ARTICLE_IMAGE_PATH, view);
+}
+
+int catner_iter_unit_code(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_ARTICLE_UNIT_CODE, view);
+}
+
+int catner_iter_unit_factor(const catner_iter_s *it, catner_str_s *view)
+{
+	return libcatner_iter_view(it, -1, LIBCATNER_NAME_ARTICLE_UNIT_FACTOR, view);
 }
 
+//
+// INIT / FREE / INPUT / OUTPUT / DEBUG
+// 
+
 /*
  * TODO documentation
  */
-int catner_del_weight_feature(catner_state_s *cs, const char *aid)
+int catner_write_xml(catner_state_s *cs, const char *path)
 {
-	return catner_del_feature(cs, aid, LIBCATNER_FEATURE_WEIGHT);
+	return xmlSaveFormatFileEnc(path, cs->doc, LIBCATNER_XML_ENCODING, 1);
 }
 
 /*
- * TODO documentation
+ * Like catner_write_xml(), but lets the caller choose between indented and 
+ * compact output, gzip compression with the given level (1 to 9, 0 for none) 
+ * and the size of the buffer used for writing to the file, see 
+ * `catner_save_opts_s`. Without indentation, no whitespace is added, but 
+ * whitespace that was loaded from a file is kept. Passing NULL for `opts` 
+ * is the same as catner_write_xml(). Returns the number of (uncompressed) 
+ * bytes written or -1 on error.
  */
-int catner_del_variant(catner_state_s *cs, const char *aid, 
-		const char *fid, const char *vid)
+int catner_write_xml_ext(catner_state_s *cs, const char *path, const catner_save_opts_s *opts)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
-
-	if (article == NULL)
+	if (opts == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_AID;
-		return -1;
+		return catner_write_xml(cs, path);
 	}
 
-	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
-		cs->_curr_feature;
-
-	if (feature == NULL)
+	if (opts->gzip < 0 || opts->gzip > 9)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_FID;
+		cs->error = LIBCATNER_ERR_INVALID_VALUE;
 		return -1;
 	}
 
-	xmlNodePtr variant = vid ? libcatner_get_variant(feature, BAD_CAST vid) : 
-		cs->_curr_variant;
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	return libcatner_save_to(cs, fd == -1 ? NULL : libcatner_open_output(fd, opts), opts->indent);
+}
 
-	if (variant == NULL)
+/*
+ * Serializes the document like catner_write_xml_ext() and passes the output 
+ * to `on_write` in pieces, along with `ctx`, which should return the number 
+ * of bytes written (all of them) or -1 on error. Once done, or after an error,
+ * `on_close` is called with `ctx`, unless it's NULL. Of the options, which may 
+ * be NULL, only `indent` applies; compressing is left to the callbacks.
+ * Returns the number of bytes written or -1 on error.
+ */
+int catner_write_xml_cb(catner_state_s *cs, catner_write_func on_write, catner_close_func on_close, 
+		void *ctx, const catner_save_opts_s *opts)
+{
+	if (opts && opts->gzip)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_VID;
+		cs->error = LIBCATNER_ERR_INVALID_VALUE;
 		return -1;
 	}
 
-	// Are we about to delete the currently selected variant?
-	if (cs->_curr_variant == variant)
+	xmlOutputBufferPtr out = xmlOutputBufferCreateIO(on_write, on_close, ctx, NULL);
+	if (out == NULL && on_close)
 	{
-		cs->_curr_variant = NULL;
+		on_close(ctx);
 	}
-
-	libcatner_del_node(variant);
-	return 0;
+	return libcatner_save_to(cs, out, opts ? opts->indent : 1);
 }
 
 /*
- * TODO documentation
+ * Writes the document to `path` like catner_write_xml(), with byte-identical 
+ * output, but the children of T_NEW_CATALOG, i.e. the articles, are split 
+ * into `threads` ranges that are serialized at the same time. If `threads` 
+ * is 0 or less, one thread per online CPU is used. Everything else is 
+ * serialized once, in the calling thread. As all ranges are held in memory 
+ * until written, this needs about as much memory as the output is large.
+ *
+ * If T_NEW_CATALOG has children other than elements and text, such as 
+ * comments, whose indentation we don't try to replicate, this falls back to 
+ * catner_write_xml(). Returns the number of bytes written, INT_MAX if that 
+ * is more, or -1 on error.
  */
-int catner_del_weight_variant(catner_state_s *cs, const char *aid, const char *vid)
-{
-	return catner_del_variant(cs, aid, LIBCATNER_FEATURE_WEIGHT, vid);
-}
-
-//
-// NUM
-//
-
-size_t catner_num_territories(catner_state_s *cs)
-{
-	return libcatner_num_children(cs->catalog, BMECAT_NODE_TERRITORY, NULL);
-}
-
-size_t catner_num_articles(catner_state_s *cs)
-{
-	return libcatner_num_children(cs->articles, BMECAT_NODE_ARTICLE, NULL);
-}
-
-size_t catner_num_article_categories(catner_state_s *cs, const char *aid)
+int catner_write_xml_parallel(catner_state_s *cs, const char *path, int threads)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
-
-	if (article == NULL)
+	if (threads <= 0)
 	{
-		return 0;
+		threads = sysconf(_SC_NPROCESSORS_ONLN);
 	}
 
-	return libcatner_num_children(article, BMECAT_NODE_ARTICLE_CATEGORY, NULL);
-}
-
-size_t catner_num_article_images(catner_state_s *cs, const char *aid)
-{
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	size_t num_nodes = 0;
+	for (xmlNodePtr node = cs->articles->children; node; node = node->next, ++num_nodes)
+	{
+		if (node->type != XML_ELEMENT_NODE && node->type != XML_TEXT_NODE)
+		{
+			threads = 1;
+		}
+	}
 
-	if (article == NULL)
+	if (threads <= 1 || num_nodes < 2)
 	{
-		return 0;
+		return catner_write_xml(cs, path);
+	}
+	if ((size_t) threads > num_nodes)
+	{
+		threads = num_nodes;
 	}
 
-	xmlNodePtr images = libcatner_get_child(article, BMECAT_NODE_ARTICLE_IMAGES, NULL, 0);
+	// libxml stops indenting below elements with text, keeping that up below
+	int format = !libcatner_has_text(cs->root) && !libcatner_has_text(cs->articles);
 
-	if (images == NULL)
+	libcatner_membuf_s skeleton = { 0 };
+	const char *head, *tail;
+	size_t head_len, tail_len;
+	if (libcatner_dump_skeleton(cs, format, &skeleton, &head, &head_len, &tail, &tail_len) != 0)
 	{
-		return 0;
+		free(skeleton.data);
+		return catner_write_xml(cs, path);
 	}
 
-	return libcatner_num_children(images, BMECAT_NODE_ARTICLE_IMAGE, NULL);
-}
+	libcatner_part_s *parts = calloc(threads, sizeof(libcatner_part_s));
+	FILE *fp = parts ? fopen(path, "wb") : NULL;
+	if (fp == NULL)
+	{
+		free(parts);
+		free(skeleton.data);
+		cs->error = parts ? LIBCATNER_ERR_OTHER : LIBCATNER_ERR_OUT_OF_MEMORY;
+		return -1;
+	}
 
-size_t catner_num_article_units(catner_state_s *cs, const char *aid)
-{
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	libcatner_start_parts(cs, parts, threads, num_nodes, format, NULL);
 
-	if (article == NULL)
+	// Write the ranges in order, as they come in
+	int ok = fwrite(head, 1, head_len, fp) == head_len;
+	size_t total = head_len + tail_len;
+	for (int i = 0; i < threads; ++i)
 	{
-		return 0;
+		libcatner_part_s *part = &parts[i];
+		ok = (libcatner_join_part(part) == 0) && ok;
+		ok = ok && fwrite(part->mem.data, 1, part->mem.len, fp) == part->mem.len;
+		total += part->mem.len;
+		free(part->mem.data);
 	}
+	ok = ok && fwrite(tail, 1, tail_len, fp) == tail_len;
+	ok = (fclose(fp) == 0) && ok;
 
-	xmlNodePtr units = libcatner_get_child(article, BMECAT_NODE_ARTICLE_UNITS, NULL, 0);
+	free(parts);
+	free(skeleton.data);
 
-	if (units == NULL)
+	if (!ok)
 	{
-		return 0;
+		cs->error = LIBCATNER_ERR_OTHER;
+		return -1;
 	}
 
-	return libcatner_num_children(units, BMECAT_NODE_ARTICLE_ALT_UNIT, NULL);
+	// Like libxml, report the size of huge files as the largest int
+	return total > INT_MAX ? INT_MAX : (int) total;
 }
 
-size_t catner_num_features(catner_state_s *cs, const char *aid)
+/*
+ * Writes the document into several files, each with a copy of everything but 
+ * the children of T_NEW_CATALOG, i.e. HEADER and all, and with at most 
+ * `max_articles` of the articles and `max_bytes` bytes in total. Either limit 
+ * can be 0 to disable it. The file names are made from `pattern`, which must 
+ * contain exactly one `%d` (flags and field width like `%03d` are fine) that 
+ * is replaced with the number of the file, starting with 1.
+ *
+ * The articles are serialized by `threads` threads, and the files are then 
+ * written by as many, or one per online CPU if `threads` is 0 or less. Each 
+ * file is formatted like the respective part of catner_write_xml()'s output. 
+ * Returns the number of files written or -1 on error, in which case some 
+ * files might have been written already. If an article doesn't fit into 
+ * `max_bytes` on its own, the error is LIBCATNER_ERR_INVALID_VALUE and no 
+ * files are written.
+ */
+int catner_write_xml_split(catner_state_s *cs, const char *pattern, size_t max_articles, 
+		size_t max_bytes, int threads)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	if (pattern == NULL || libcatner_check_pattern(pattern) != 0)
+	{
+		cs->error = LIBCATNER_ERR_INVALID_VALUE;
+		return -1;
+	}
+	if (threads <= 0)
+	{
+		threads = sysconf(_SC_NPROCESSORS_ONLN);
+	}
 
-	if (article == NULL)
+	size_t num_nodes = 0;
+	for (xmlNodePtr node = cs->articles->children; node; node = node->next)
 	{
-		return 0;
+		++num_nodes;
 	}
+	int num_parts = (size_t) threads > num_nodes ? (int) num_nodes : threads;
 
-	return libcatner_num_features(article);
-}
+	// libxml stops indenting below elements with text, keeping that up below
+	int format = !libcatner_has_text(cs->root) && !libcatner_has_text(cs->articles);
 
-size_t catner_num_variants(catner_state_s *cs, const char *aid, const char *fid)
-{
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	libcatner_split_s split = { 0 };
+	split.pattern = pattern;
 
-	if (article == NULL)
+	libcatner_membuf_s skeleton = { 0 };
+	libcatner_part_s *parts = calloc(num_parts + 1, sizeof(libcatner_part_s));
+	size_t *ends = malloc((num_nodes + 1) * sizeof(size_t));
+	split.nodes  = malloc((num_nodes + 1) * sizeof(char *));
+	split.lens   = malloc((num_nodes + 1) * sizeof(size_t));
+	split.firsts = malloc((num_nodes + 2) * sizeof(size_t));
+	libcatner_split_job_s *jobs = calloc(threads, sizeof(libcatner_split_job_s));
+
+	int ok = 0;
+	if (!parts || !ends || !split.nodes || !split.lens || !split.firsts || !jobs)
 	{
-		return 0;
+		cs->error = LIBCATNER_ERR_OUT_OF_MEMORY;
 	}
-
-	xmlNodePtr feature = fid ? libcatner_get_feature(article, BAD_CAST fid) :
-		cs->_curr_feature;
-
-	if (feature == NULL)
+	else if (libcatner_dump_skeleton(cs, format, &skeleton, &split.head, &split.head_len, 
+				&split.tail, &split.tail_len) != 0)
 	{
-		return 0;
+		cs->error = LIBCATNER_ERR_OTHER;
+	}
+	else
+	{
+		// Serialize the children of T_NEW_CATALOG, remembering where each ends
+		libcatner_start_parts(cs, parts, num_parts, num_nodes, format, ends);
+		ok = 1;
+		for (int i = 0; i < num_parts; ++i)
+		{
+			ok = (libcatner_join_part(&parts[i]) == 0) && ok;
+		}
+		if (!ok)
+		{
+			cs->error = LIBCATNER_ERR_OTHER;
+		}
 	}
 
-	return libcatner_num_variants(feature);
-}
-
-//
-// HAS
-// 
+	if (ok)
+	{
+		size_t n = 0;
+		for (int i = 0; i < num_parts; ++i)
+		{
+			for (size_t k = 0; k < parts[i].num_nodes; ++k, ++n)
+			{
+				size_t start = k ? ends[n - 1] : 0;
+				split.nodes[n] = parts[i].mem.data + start;
+				split.lens[n]  = ends[n] - start;
+			}
+		}
 
-int catner_has_article_title(catner_state_s *cs, const char *aid)
-{
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+		if (libcatner_plan_split(cs, &split, num_nodes, max_articles, max_bytes) != 0)
+		{
+			cs->error = LIBCATNER_ERR_INVALID_VALUE;
+			ok = 0;
+		}
+	}
 
-	if (article == NULL)
+	if (ok)
 	{
-		return 0;
+		// Write the files, each thread taking every `num_jobs`-th of them
+		split.num_jobs = (size_t) threads > split.num_files ? (int) split.num_files : threads;
+		for (int i = 0; i < split.num_jobs; ++i)
+		{
+			jobs[i].split = &split;
+			jobs[i].first = i;
+			jobs[i].started = pthread_create(&jobs[i].thread, NULL, libcatner_write_split, &jobs[i]) == 0;
+		}
+		for (int i = 0; i < split.num_jobs; ++i)
+		{
+			if (jobs[i].started)
+			{
+				pthread_join(jobs[i].thread, NULL);
+			}
+			else
+			{
+				libcatner_write_split(&jobs[i]);
+			}
+			ok = (jobs[i].ret == 0) && ok;
+		}
+		if (!ok)
+		{
+			cs->error = LIBCATNER_ERR_OTHER;
+		}
 	}
 
-	xmlNodePtr details = libcatner_get_child(article, BMECAT_NODE_ARTICLE_DETAILS, NULL, 0);
-	
-	if (details == NULL)
+	for (int i = 0; parts && i < num_parts; ++i)
 	{
-		return 0;
+		free(parts[i].mem.data);
 	}
+	free(parts);
+	free(ends);
+	free(split.nodes);
+	free(split.lens);
+	free(split.firsts);
+	free(jobs);
+	free(skeleton.data);
 
-	return libcatner_has_child(details, BMECAT_NODE_ARTICLE_TITLE, 0);
+	if (!ok || split.num_files > INT_MAX)
+	{
+		return -1;
+	}
+	return split.num_files;
 }
 
-int catner_has_article_descr(catner_state_s *cs, const char *aid)
+/*
+ * Serializes the document like catner_write_xml_ext() into a newly allocated,
+ * null-terminated buffer, which is returned via `buf` and has to be freed by 
+ * the caller, and stores its length, not counting the terminator, in `len`. 
+ * Of the options, which may be NULL, only `indent` applies. Returns the 
+ * number of bytes written or -1 on error, in which case `buf` is set to NULL.
+ */
+int catner_write_xml_mem(catner_state_s *cs, char **buf, size_t *len, const catner_save_opts_s *opts)
 {
-	xmlNodePtr article = aid ? libcatner_get_article(cs->articles, BAD_CAST aid) :
-		cs->_curr_article;
+	libcatner_membuf_s mem = { 0 };
+	int ret = catner_write_xml_cb(cs, libcatner_write_mem, NULL, &mem, opts);
 
-	if (article == NULL)
+	// Null-terminate, which also gives us a buffer for empty output
+	if (ret >= 0 && libcatner_write_mem(&mem, "", 1) != 1)
 	{
-		return 0;
+		cs->error = LIBCATNER_ERR_OUT_OF_MEMORY;
+		ret = -1;
 	}
-
-	xmlNodePtr details = libcatner_get_child(article, BMECAT_NODE_ARTICLE_DETAILS, NULL, 0);
-	
-	if (details == NULL)
+	if (ret < 0)
 	{
-		return 0;
+		free(mem.data);
+		*buf = NULL;
+		return -1;
 	}
 
-	return libcatner_has_child(details, BMECAT_NODE_ARTICLE_DESCR, 0);
+	*buf = mem.data;
+	*len = mem.len - 1;
+	return ret;
 }
 
-int catner_has_article_images(catner_state_s *cs, const char *aid)
+/*
+ * TODO documentation
+ */
+int catner_print_xml(catner_state_s *cs)
 {
-	return catner_num_article_images(cs, aid) > 0;
+	return xmlSaveFormatFileEnc(LIBCATNER_STDOUT_FILE, cs->doc, LIBCATNER_XML_ENCODING, 1);
 }
 
-int catner_has_article_categories(catner_state_s *cs, const char *aid)
+/*
+ * Write the document back to the file it was originally loaded from.
+ * The document is written to a temporary file first, which is flushed to 
+ * disk and then renamed, so that the file is never left half-written. If 
+ * the document hasn't been modified, see catner_is_dirty(), nothing is 
+ * written and 0 is returned.
+ */
+int catner_save(catner_state_s *cs)
 {
-	return catner_num_article_categories(cs, aid) > 0;
+	return catner_save_ext(cs, NULL);
 }
 
-//
-// SEL
-//
-
 /*
- * Set the currently selected article to the one identified by the given
- * `aid`. If the article was found, it will be selected and 0 is returned.
- * Otherwise, the selected article will not be changed and -1 is returned.
+ * Like catner_save(), but with the options of catner_write_xml_ext(). Set 
+ * `nosync` to skip flushing the file to disk, which is a lot faster, but 
+ * leaves it up to the OS whether the file survives a crash of the system 
+ * (not of the program) with its old content, its new content or neither. 
+ * Returns the number of bytes written or -1 on error.
  */
-int catner_sel_article(catner_state_s *cs, const char *aid)
+int catner_save_ext(catner_state_s *cs, const catner_save_opts_s *opts)
 {
-	xmlNodePtr article = libcatner_get_article(cs->articles, BAD_CAST aid);
-	if (article == NULL)
+	if (cs->path == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		cs->error = LIBCATNER_ERR_OTHER;
 		return -1;
 	}
-	
-	// Check if this is different from the currently selected article
-	if (cs->_curr_article != article)
-	{
-		// If so, update the reference
-		cs->_curr_article = article;
 
-		// We also have to reset feature and variant selection
-		cs->_curr_feature = NULL;
-		cs->_curr_variant = NULL;
-		cs->_curr_image   = NULL;
-		cs->_curr_unit    = NULL;
+	if (opts && (opts->gzip < 0 || opts->gzip > 9))
+	{
+		cs->error = LIBCATNER_ERR_INVALID_VALUE;
+		return -1;
 	}
 
-	return 0;
-}
-
-/*
- * Set the currently selected article to the first article there is, or NULL 
- * if there is none. If the first article was already selected, this function 
- * does nothing. Otherwise, the current feature and variant selection will be 
- * reset to NULL. Returns 0 if there is now an article selected, otherwise -1.
- */
-int catner_sel_first_article(catner_state_s *cs)
-{
-	// Let's find the first article
-	xmlNodePtr first = libcatner_get_child(cs->articles, BMECAT_NODE_ARTICLE, NULL, 0);
-	
-	// Check if this is different from the currently selected article
-	if (cs->_curr_article != first)
+	// Nothing changed since loading or the last save, the file is up to date
+	if (!cs->_dirty)
 	{
-		// If so, update the reference
-		cs->_curr_article = first;
-
-		// We also have to reset feature and variant selection
-		cs->_curr_feature = NULL;
-		cs->_curr_variant = NULL;
-		cs->_curr_image   = NULL;
-		cs->_curr_unit    = NULL;
+		return 0;
 	}
 
-	if (cs->_curr_article == NULL)
+	catner_save_opts_s defaults = { .indent = 1 };
+	int ret = libcatner_save_atomic(cs, cs->path, opts ? opts : &defaults);
+	if (ret >= 0)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		cs->_dirty = 0;
 	}
-	return 0;
+	return ret;
 }
 
 /*
- * Change the currently selected article to the next one there is, or NULL.
- * If no article was selected, this function will do nothing and return 0.
- * Otherwise, the currently selected feature and variant will be reset, too.
- * Returns 0 if there was another article and it was selected, otherwise -1.
+ * Returns 1 if the document has been modified since it was loaded or last 
+ * saved with catner_save(), otherwise 0. Setting a value to what it already 
+ * is doesn't count as a modification. Documents created with catner_init(), 
+ * or loaded with elements added because of `amend`, start out modified.
  */
-int catner_sel_next_article(catner_state_s *cs)
+int catner_is_dirty(catner_state_s *cs)
 {
-	// If we have no article currently selected, abort
-	if (cs->_curr_article == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
-		return -1;
-	}
-
-	// Now we'll advance to the next article
-	cs->_curr_article = libcatner_next_node(cs->_curr_article);
-	
-	// Change of article means we've got to reset selected feature and variant
-	cs->_curr_feature = NULL;
-	cs->_curr_variant = NULL;
-	cs->_curr_image   = NULL;
-	cs->_curr_unit    = NULL;
-
-	if (cs->_curr_article == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
-	}
-	return 0;
+	return cs->_dirty;
 }
 
-int catner_sel_feature(catner_state_s *cs, const char *fid)
+/*
+ * Creates and returns a `catner_state_s` struct, which holds a reference to 
+ * an XML tree which holds some basic elements required to construct a valid 
+ * kloeckner-style BMEcat XML file. Returns NULL if out of memory. 
+ */
+catner_state_s *catner_init()
 {
-	// Can't select a feature if no article selected
-	if (cs->_curr_article == NULL)
+	catner_state_s *state = malloc(sizeof(catner_state_s));
+	if (state == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
-		return -1;
+		return NULL;
 	}
+	catner_state_s empty_state = { 0 };
+	*state = empty_state;
 
-	xmlNodePtr feature = libcatner_get_feature(cs->_curr_article, BAD_CAST fid);
-
-	if (feature == NULL)
+	state->doc       = xmlNewDoc(BAD_CAST LIBCATNER_XML_VERSION);
+	if (state->doc == NULL || libcatner_intern_names(state) != 0)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		catner_free(state);
+		return NULL;
 	}
 
-	// The selected feature has changed?
-	if (cs->_curr_feature != feature)
-	{
-		// Update the feature selection
-		cs->_curr_feature = feature;
+	state->root      = libcatner_get_root(state->doc, 1);
+	state->header    = libcatner_get_header(state->root, 1);
+	state->articles  = libcatner_get_articles(state->root, 1);
+	state->catalog   = libcatner_get_catalog(state->header, 1);
 
-		// Therefore, also reset the current variant selection
-		cs->_curr_variant = NULL;
+	if (libcatner_build_aid_index(state) != 0)
+	{
+		catner_free(state);
+		return NULL;
 	}
 
-	return 0;
+	return state;
 }
 
 /*
- * Set the currently selected feature to the first one of the currently 
- * selected article, if any. If the first feature was already selected before, 
- * this function does nothing and returns 1. If the selection was changed, 
- * the current variant selection will be reset and the function returns 1 if 
- * there is now a feature selected or 0 if no feature could be selected. 
+ * Loads the given kloeckner-style BMEcat XML file into memory and returns 
+ * a `catner_state_s` struct that allows reading and manipulating the XML. 
+ *
+ * If `amend` is `1`, required elements that are missing in the file will be
+ * added on import. If an empty document is imported, this will create the 
+ * basic outline of a kloeckner-style BMEcat file, including the BMECAT, 
+ * HEADER, CATALOG and T_NEW_CATALOG nodes. If `amend` is `0` and the imported 
+ * file is missing some of the required elements, this function returns `NULL`.
  */
-int catner_sel_first_feature(catner_state_s *cs)
+catner_state_s *catner_load(const char *path, int amend)
 {
-	// Can't select a feature if no article selected
-	if (cs->_curr_article == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
-		return -1;
-	}
-	
-	// Find the node containing all features 
-	xmlNodePtr features = libcatner_get_child(cs->_curr_article, BMECAT_NODE_FEATURES, NULL, 0);
-	if (features == NULL)
-	{
-		// The selected article doesn't have any features
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
-	}
-
-	// Find the first feature or NULL if there aren't any
-	xmlNodePtr first = libcatner_get_child(features, BMECAT_NODE_FEATURE, NULL, 0);
+	return libcatner_load_doc(xmlReadFile(path, NULL, 0), path, amend);
+}
 
-	// The selected feature has changed?
-	if (cs->_curr_feature != first)
+/*
+ * Like catner_load(), but lets the caller tune how the file is parsed, see 
+ * `catner_load_opts_s`. Passing NULL for `opts` is the same as catner_load().
+ *
+ * `noblanks` drops the whitespace between elements, which otherwise shows up 
+ * as text nodes between all element siblings, and lets catner_write_xml() 
+ * indent the output from scratch. `compact` saves memory on the many short 
+ * text nodes. `huge` is needed for files that exceed libxml's default limits.
+ * If `dict` is set, element names and short strings are interned in that 
+ * dictionary, which can then be shared by several documents loaded after one 
+ * another; it must not be used by two threads at the same time and the caller 
+ * keeps its own reference.
+ */
+catner_state_s *catner_load_ext(const char *path, int amend, const catner_load_opts_s *opts)
+{
+	if (opts == NULL)
 	{
-		// Update the feature selection
-		cs->_curr_feature = first;
-
-		// Therefore, also reset the current variant selection
-		cs->_curr_variant = NULL;
+		return catner_load(path, amend);
 	}
 
-	if (cs->_curr_feature == NULL)
+	int options = 0;
+	xmlParserCtxtPtr ctxt = libcatner_new_parser(opts, &options);
+	if (ctxt == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		return NULL;
 	}
-	return 0;
+
+	xmlDocPtr doc = xmlCtxtReadFile(ctxt, path, NULL, options);
+	xmlFreeParserCtxt(ctxt);
+
+	return libcatner_load_doc(doc, path, amend);
 }
 
 /*
- * TODO documentation
+ * Like catner_load_ext(), but splits the articles of the file into chunks 
+ * that are parsed by `threads` threads at the same time, then moves them into 
+ * one document. If `threads` is 0 or less, one thread per online CPU is used. 
+ * `opts` may be NULL, a shared dictionary is only used for the main document.
+ *
+ * The chunks are found by looking for ARTICLE start tags in the raw file, so 
+ * this only works for files where T_NEW_CATALOG and ARTICLE are not prefixed 
+ * and there's no DOCTYPE. For those, and whenever a chunk fails to parse, it 
+ * falls back to catner_load_ext(), hence the result is always the same.
  */
-int catner_sel_next_feature(catner_state_s *cs)
+catner_state_s *catner_load_parallel(const char *path, int amend, int threads, 
+		const catner_load_opts_s *opts)
 {
-	// Make sure we currently have a feature selected, otherwise abort
-	if (cs->_curr_feature == NULL)
+	if (threads <= 0)
 	{
-		cs->error = LIBCATNER_ERR_NO_SEL_FEATURE;
-		return -1;
+		threads = sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (threads <= 1)
+	{
+		return catner_load_ext(path, amend, opts);
 	}
 
-	// Now we'll advance to the next feature
-	cs->_curr_feature = libcatner_next_node(cs->_curr_feature);
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+	{
+		return catner_load_ext(path, amend, opts);
+	}
 
-	// Change of feature means we've to to reset the selected variant
-	cs->_curr_variant = NULL;
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size == 0)
+	{
+		close(fd);
+		return catner_load_ext(path, amend, opts);
+	}
 
-	if (cs->_curr_feature == NULL)
+	void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;	
+		return catner_load_ext(path, amend, opts);
 	}
-	return 0;
+
+	catner_state_s *state = libcatner_load_chunked(map, st.st_size, path, 
+			amend, threads, opts);
+	munmap(map, st.st_size);
+
+	return state ? state : catner_load_ext(path, amend, opts);
 }
 
 /*
- * TODO documentation
+ * Like catner_load(), but parses the file from a read-only memory mapping 
+ * instead of reading it through a buffer, which saves copying the data out 
+ * of the page cache. Falls back to catner_load() if the file can't be mapped.
  */
-int catner_sel_first_variant(catner_state_s *cs)
+catner_state_s *catner_load_mmap(const char *path, int amend)
 {
-	// Check if we have a feature selected, otherwise abort
-	if (cs->_curr_feature == NULL)
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
 	{
-		cs->error = LIBCATNER_ERR_NO_SEL_FEATURE;
-		return -1;
+		return libcatner_load_doc(NULL, path, amend);
 	}
 
-	// Find the node containing all variants of this feature
-	xmlNodePtr variants = libcatner_get_child(cs->_curr_feature, BMECAT_NODE_VARIANTS, NULL, 0);
-	if (variants == NULL)
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size == 0 || st.st_size > INT_MAX)
 	{
-		// The selected feature doesn't have any variants
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		close(fd);
+		return catner_load(path, amend);
 	}
 
-	// Find the first variant
-	cs->_curr_variant = libcatner_get_child(variants, BMECAT_NODE_VARIANT, NULL, 0);
-		
-	if (cs->_curr_variant == NULL)
+	void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		return catner_load(path, amend);
 	}
-	return 0;
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	// The tree doesn't reference the input, so we can unmap it right away
+	xmlDocPtr doc = xmlReadMemory(map, st.st_size, path, NULL, 0);
+	munmap(map, st.st_size);
+
+	return libcatner_load_doc(doc, path, amend);
 }
 
 /*
- * TODO documentation
+ * Like catner_load(), but parses the `len` bytes at `buf` instead of a file.
+ * The buffer is parsed in place and is not referenced after this function 
+ * returns. As there is no file to write back to, catner_save() can't be used 
+ * with the returned state. Returns NULL on error or if `len` exceeds INT_MAX.
  */
-int catner_sel_next_variant(catner_state_s *cs)
+catner_state_s *catner_load_memory(const char *buf, size_t len, int amend)
 {
-	// Abort right away if we don't currently have a variant selected
-	if (cs->_curr_variant == NULL)
+	if (len > INT_MAX)
 	{
-		cs->error = LIBCATNER_ERR_NO_SEL_VARIANT;
-		return -1;
+		return NULL;
 	}
+	return libcatner_load_doc(xmlReadMemory(buf, len, NULL, NULL, 0), NULL, amend);
+}
 
-	// Now we'll advance to the next variant
-	cs->_curr_variant = libcatner_next_node(cs->_curr_variant);
-
-	if (cs->_curr_variant == NULL)
-	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
-	}
-	return 0;
+/*
+ * Like catner_load(), but reads the document from the given file descriptor, 
+ * which can also be a pipe or socket, until end of file. The descriptor is 
+ * not closed. As there is no file to write back to, catner_save() can't be 
+ * used with the returned state.
+ */
+catner_state_s *catner_load_fd(int fd, int amend)
+{
+	return libcatner_load_doc(xmlReadFd(fd, NULL, NULL, 0), NULL, amend);
 }
 
 /*
- * TODO documentation
+ * Opens the given kloeckner-style BMEcat XML file for reading in streaming 
+ * mode and returns a `catner_state_s` struct that gives access to the data 
+ * of the HEADER (LOCALE, TERRITORY, GENERATOR_INFO, ...) right away. The 
+ * articles can then be read one at a time with catner_stream_next(). 
+ *
+ * Only the HEADER and the current article are held in memory, hence all 
+ * getters work as usual, but articles other than the current one can't be 
+ * accessed. The returned state is not associated with the file, so that 
+ * catner_save() can't accidentally overwrite it. Returns NULL on error.
  */
-int catner_sel_first_image(catner_state_s *cs)
+catner_state_s *catner_load_stream(const char *path)
 {
-	// Abort if no article selected
-	if (cs->_curr_article == NULL)
+	catner_state_s *state = malloc(sizeof(catner_state_s));
+	if (state == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
-		return -1;
+		return NULL;
 	}
+	catner_state_s empty_state = { 0 };
+	*state = empty_state;
 
-	// Get the MIME_INFO node that contains all images
-	xmlNodePtr images = libcatner_get_child(cs->_curr_article, BMECAT_NODE_ARTICLE_IMAGES, NULL, 0);
-	if (images == NULL)
+	state->doc = xmlNewDoc(BAD_CAST LIBCATNER_XML_VERSION);
+	if (state->doc == NULL || libcatner_intern_names(state) != 0)
 	{
-		// The selected article doesn't have any images
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		catner_free(state);
+		return NULL;
 	}
 
-	// Find the first image
-	cs->_curr_image = libcatner_get_child(images, BMECAT_NODE_ARTICLE_IMAGE, NULL, 0);
+	// Read everything up to the first article
+	state->_reader = xmlReaderForFile(path, NULL, 0);
+	if (state->_reader == NULL || libcatner_stream_header(state) != 0)
+	{
+		catner_free(state);
+		return NULL;
+	}
 
-	if (cs->_curr_image == NULL)
+	// Make sure all required nodes exist, even if the file lacks them
+	state->header    = libcatner_get_header(state->root, 1);
+	state->articles  = libcatner_get_articles(state->root, 1);
+	state->catalog   = libcatner_get_catalog(state->header, 1);
+	state->generator = libcatner_get_generator(state->header, 0);
+
+	if (libcatner_build_aid_index(state) != 0)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		catner_free(state);
+		return NULL;
 	}
-	return 0;
+
+	return state;
 }
 
 /*
- * TODO documentation
+ * Reads only what comes before the first article of the given kloeckner-style
+ * BMEcat XML file and returns a state that holds the HEADER, but no articles, 
+ * so that catner_get_locale(), catner_get_territories(), catner_get_generator()
+ * and friends can be used as usual. Reading stops at the first article.
+ *
+ * If `num_articles` is not NULL, the whole file is read with a SAX parser 
+ * afterwards, which counts the ARTICLE elements without building any nodes.
+ * The returned state is not associated with the file, so that catner_save() 
+ * can't accidentally drop its articles. Returns NULL on error.
  */
-int catner_sel_next_image(catner_state_s *cs)
+catner_state_s *catner_peek(const char *path, size_t *num_articles)
 {
-	// Abort if not currently any image selected
-	if (cs->_curr_image == NULL)
+	catner_state_s *state = catner_load_stream(path);
+	if (state == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SEL_IMAGE;
-		return -1;
+		return NULL;
 	}
 
-	// Now we'll advance to the next image
-	cs->_curr_image = libcatner_next_node(cs->_curr_image);
+	xmlFreeTextReader(state->_reader);
+	state->_reader = NULL;
 
-	if (cs->_curr_image == NULL)
+	if (num_articles && libcatner_count_articles(path, num_articles) != 0)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		catner_free(state);
+		return NULL;
 	}
-	return 0;
+	return state;
 }
 
 /*
- * TODO documentation
+ * Loads the given kloeckner-style BMEcat XML file like catner_load(), but 
+ * only keeps the articles for which the `filter` function returns 1 when 
+ * given the article's AID and `data`. If it returns -1, no further articles 
+ * are read. Articles without AID are skipped. The file is read in streaming 
+ * mode, so skipped articles are never held in memory along with the others.
+ *
+ * As the returned state doesn't hold all articles of the file, it is not 
+ * associated with the file, so that catner_save() can't accidentally drop 
+ * the articles that weren't loaded. Returns NULL on error.
  */
-int catner_sel_first_unit(catner_state_s *cs)
+catner_state_s *catner_load_filter(const char *path, catner_aid_filter filter, void *data)
 {
-	// Abort if no article selected
-	if (cs->_curr_article == NULL)
+	catner_state_s *state = catner_load_stream(path);
+	if (state == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SEL_ARTICLE;
-		return -1;
+		return NULL;
 	}
 
-	// Get the ARTICLE_ORDER_DETAILS node that contains all (alternative) units
-	xmlNodePtr units = libcatner_get_child(cs->_curr_article, BMECAT_NODE_ARTICLE_UNITS, NULL, 0);
-	if (units == NULL)
+	for (xmlNodePtr node; (node = libcatner_stream_article(state->_reader)) != NULL; )
 	{
-		// No units, we're done
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		const xmlChar *aid = libcatner_stream_aid(node);
+		int keep = aid ? filter((const char *) aid, data) : 0;
+		if (keep == -1)
+		{
+			break;
+		}
+		if (keep == 0)
+		{
+			continue;
+		}
+
+		xmlNodePtr article = libcatner_copy_node(state, node, state->articles, 1);
+		if (article == NULL)
+		{
+			catner_free(state);
+			return NULL;
+		}
+		libcatner_index_article(state, article);
+		++state->_num_articles;
 	}
 
-	// Find the first unit
-	cs->_curr_unit = libcatner_get_child(units, BMECAT_NODE_ARTICLE_ALT_UNIT, NULL, 0);
-	
-	if (cs->_curr_unit == NULL)
+	// Don't return a partial result if the file turned out to be broken
+	if (xmlTextReaderReadState(state->_reader) == XML_TEXTREADER_MODE_ERROR)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		catner_free(state);
+		return NULL;
 	}
-	return 0;
+
+	xmlFreeTextReader(state->_reader);
+	state->_reader = NULL;
+	return state;
 }
 
 /*
- * TODO documentation
+ * Loads only the articles with the given `aids` from the given file, see 
+ * catner_load_filter(). Reading stops as soon as all of them have been found.
+ * Returns NULL on error.
  */
-int catner_sel_next_unit(catner_state_s *cs)
+catner_state_s *catner_load_aids(const char *path, const char **aids, size_t num_aids)
 {
-	// Abort if no unit selected
-	if (cs->_curr_unit == NULL)
+	xmlHashTablePtr set = xmlHashCreate(num_aids);
+	if (set == NULL)
 	{
-		cs->error = LIBCATNER_ERR_NO_SEL_UNIT;
-		return -1;
+		return NULL;
 	}
 
-	// Get the next unit node, if there is one
-	cs->_curr_unit = libcatner_next_node(cs->_curr_unit);
-
-	if (cs->_curr_unit == NULL)
+	for (size_t i = 0; i < num_aids; ++i)
 	{
-		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
-		return -1;
+		// Fails for duplicates, which is fine
+		xmlHashAddEntry(set, BAD_CAST aids[i], set);
 	}
-	return 0;
-}
-
-//
-// INIT / FREE / INPUT / OUTPUT / DEBUG
-// 
 
-/*
- * TODO documentation
- */
-int catner_write_xml(catner_state_s *cs, const char *path)
-{
-	return xmlSaveFormatFileEnc(path, cs->doc, LIBCATNER_XML_ENCODING, 1);
+	catner_state_s *state = catner_load_filter(path, libcatner_aid_in_set, set);
+	xmlHashFree(set, NULL);
+	return state;
 }
 
 /*
- * TODO documentation
+ * Reads the next article of a state opened with catner_load_stream() and 
+ * selects it, so that it can be accessed by passing NULL as AID or with the 
+ * catner_sel_*() functions. The previous article will be discarded, as will 
+ * any changes that have been made to it. Returns 0 on success, -1 if there 
+ * are no more articles or an error occurred.
  */
-int catner_print_xml(catner_state_s *cs)
+int catner_stream_next(catner_state_s *cs)
 {
-	return xmlSaveFormatFileEnc(LIBCATNER_STDOUT_FILE, cs->doc, LIBCATNER_XML_ENCODING, 1);
-}
+	if (cs->_reader == NULL)
+	{
+		cs->error = LIBCATNER_ERR_OTHER;
+		return -1;
+	}
 
-/*
- * Write the document back to the file it was originally loaded from.
- */
-int catner_save(catner_state_s *cs)
-{
-	if (cs->path == NULL)
+	// Discard the previous article(s)
+	xmlNodePtr prev = libcatner_get_child(cs->articles, LIBCATNER_NAME_ARTICLE, NULL, 0);
+	while (prev)
+	{
+		xmlNodePtr next = libcatner_next_node(prev);
+		libcatner_del_article(cs, prev);
+		prev = next;
+	}
+
+	xmlNodePtr node = libcatner_stream_article(cs->_reader);
+	if (node == NULL)
+	{
+		cs->error = LIBCATNER_ERR_NO_SUCH_NODE;
+		return -1;
+	}
+
+	xmlNodePtr article = libcatner_copy_node(cs, node, cs->articles, 1);
+	if (article == NULL)
 	{
+		cs->error = LIBCATNER_ERR_OUT_OF_MEMORY;
 		return -1;
 	}
 
-	return catner_write_xml(cs, cs->path);
+	libcatner_index_article(cs, article);
+	++cs->_num_articles;
+
+	// Select the new article
+	cs->_curr_article = article;
+	cs->_curr_feature = NULL;
+	cs->_curr_variant = NULL;
+	cs->_curr_image   = NULL;
+	cs->_curr_unit    = NULL;
+	return 0;
 }
 
 /*
- * Creates and returns a `catner_state_s` struct, which holds a reference to 
- * an XML tree which holds some basic elements required to construct a valid 
- * kloeckner-style BMEcat XML file. Returns NULL if out of memory. 
+ * Creates a state for writing a kloeckner-style BMEcat XML file to `path` in 
+ * streaming mode. The state can be used like one created with catner_init(), 
+ * but articles are written to the file and discarded as soon as the next 
+ * article is added, hence only the most recently added article can still be 
+ * accessed and modified. The HEADER is written along with the first article, 
+ * so it has to be complete by then. Apart from the AIDs, which are needed to 
+ * detect duplicates, memory usage does not grow with the number of articles.
+ * Call catner_stream_end() to finish the file. Returns NULL on error.
  */
-catner_state_s *catner_init()
+catner_state_s *catner_init_stream(const char *path)
 {
-	catner_state_s *state = malloc(sizeof(catner_state_s));
+	catner_state_s *state = catner_init();
 	if (state == NULL)
 	{
 		return NULL;
 	}
-	catner_state_s empty_state = { 0 };
-	*state = empty_state;
 
-	state->doc       = xmlNewDoc(BAD_CAST LIBCATNER_XML_VERSION);
-	state->root      = libcatner_get_root(state->doc, 1);
-	state->header    = libcatner_get_header(state->root, 1);
-	state->articles  = libcatner_get_articles(state->root, 1);
-	state->catalog   = libcatner_get_catalog(state->header, 1);
+	state->_writer = xmlNewTextWriterFilename(path, 0);
+	if (state->_writer == NULL)
+	{
+		catner_free(state);
+		return NULL;
+	}
 
+	xmlTextWriterSetIndent(state->_writer, 1);
+	xmlTextWriterSetIndentString(state->_writer, BAD_CAST "  ");
 	return state;
 }
 
 /*
- * Loads the given kloeckner-style BMEcat XML file into memory and returns 
- * a `catner_state_s` struct that allows reading and manipulating the XML. 
- *
- * If `amend` is `1`, required elements that are missing in the file will be
- * added on import. If an empty document is imported, this will create the 
- * basic outline of a kloeckner-style BMEcat file, including the BMECAT, 
- * HEADER, CATALOG and T_NEW_CATALOG nodes. If `amend` is `0` and the imported 
- * file is missing some of the required elements, this function returns `NULL`.
+ * Finishes the file of a state created with catner_init_stream() by writing 
+ * the remaining article and closing the document. If no articles have been 
+ * added, the HEADER is written now. The state can't be used for writing 
+ * afterwards, but still has to be freed with catner_free(), which will call 
+ * this function if it hasn't been called yet. Returns 0 on success, -1 on 
+ * error.
  */
-catner_state_s *catner_load(const char *path, int amend)
+int catner_stream_end(catner_state_s *cs)
 {
-	catner_state_s *state = malloc(sizeof(catner_state_s));
-	if (state == NULL)
+	if (cs->_writer == NULL)
 	{
-		return NULL;
+		cs->error = LIBCATNER_ERR_OTHER;
+		return -1;
 	}
-	catner_state_s empty_state = { 0 };
-	*state = empty_state;
 
-	// Load the XML file
-	state->doc  = xmlReadFile(path, NULL, 0);
-	state->path = strdup(path);
-
-	// Find (or possibly create) the BMECAT node
-	state->root = libcatner_get_root(state->doc, amend);
-	if (state->root == NULL)
-	{
-		return NULL;
-	}
+	int ret = libcatner_stream_flush(cs);
 
-	// Find (or possibly create) the HEADER node
-	state->header = libcatner_get_header(state->root, amend);
-	if (state->header == NULL)
+	// Closes T_NEW_CATALOG, BMECAT and flushes the output
+	if (ret == 0 && xmlTextWriterEndDocument(cs->_writer) < 0)
 	{
-		return NULL;
+		ret = -1;
 	}
 
-	// Find (or possibly create) the T_NEW_CATALOG node
-	state->articles = libcatner_get_articles(state->root, amend);
-	if (state->articles == NULL)
-	{
-		return NULL;
-	}
+	xmlFreeTextWriter(cs->_writer);
+	cs->_writer = NULL;
 
-	// Find (or possibly create) the CATALOG node
-	state->catalog = libcatner_get_catalog(state->header, amend);
-	if (state->catalog == NULL)
+	if (ret != 0)
 	{
-		return NULL;
+		cs->error = LIBCATNER_ERR_OTHER;
 	}
-
-	// Find (but don't create) the optional GENERATOR_INFO node
-	state->generator = libcatner_get_generator(state->header, 0);
-	
-	return state;
+	return ret;
 }
 
 /*
@@ -2159,7 +5974,28 @@ catner_state_s *catner_load(const char *path, int amend)
  */
 void catner_free(catner_state_s *cs)
 {
+	// Finish the file if the state was created for streaming output
+	if (cs->_writer)
+	{
+		catner_stream_end(cs);
+	}
+
+	// Free the bookkeeping data libxml doesn't know about
+	xmlNodePtr article = cs->articles ? 
+		libcatner_get_child(cs->articles, LIBCATNER_NAME_ARTICLE, NULL, 0) : NULL;
+	for (; article; article = libcatner_next_node(article))
+	{
+		libcatner_free_article_meta(article);
+	}
+
+	if (cs->_reader)
+	{
+		xmlFreeTextReader(cs->_reader);
+	}
+	xmlHashFree(cs->_aid_index, NULL);
+	xmlHashFree(cs->_aid_written, NULL);
 	xmlFreeDoc(cs->doc);
+	free(cs->_names);
 	xmlCleanupParser();
 	free(cs->path);
 	free(cs);
@@ -3,6 +3,9 @@
 
 #include <libxml/xmlstring.h>
 #include <libxml/tree.h>
+#include <libxml/hash.h>
+#include <libxml/xmlreader.h>
+#include <libxml/xmlwriter.h>
 
 // Name & version
 #define LIBCATNER_NAME "libcatner"
@@ -97,6 +100,14 @@ struct catner_state
 	xmlNodePtr generator;	// Pointer to GENERATOR node
 	xmlNodePtr articles;	// Pointer to T_NEW_CATALOG node
 
+	const xmlChar **_names;		// Element names, interned in doc's dict
+	xmlHashTablePtr _aid_index;	// Maps SUPPLIER_AID to ARTICLE nodes
+	size_t _num_articles;		// Number of ARTICLE nodes
+	int _dirty;			// Whether there are changes that haven't been saved
+	xmlTextReaderPtr _reader;	// Reader, if opened in streaming mode
+	xmlTextWriterPtr _writer;	// Writer, if created in streaming mode
+	xmlHashTablePtr _aid_written;	// AIDs written so far, in streaming mode
+
 	xmlNodePtr _curr_article;	// Selected article
 	xmlNodePtr _curr_feature;	// Selected features
 	xmlNodePtr _curr_variant;	// Selected variant
@@ -106,6 +117,117 @@ struct catner_state
 
 typedef struct catner_state catner_state_s;
 
+struct catner_load_opts
+{
+	int noblanks;		// Drop whitespace-only text nodes (indentation)
+	int compact;		// Store short text content inside the nodes
+	int huge;		// Lift libxml's limits on text and nesting depth
+	xmlDictPtr dict;	// Dictionary to share between documents, or NULL
+};
+
+typedef struct catner_load_opts catner_load_opts_s;
+
+struct catner_save_opts
+{
+	int indent;		// Indent nested elements
+	int gzip;		// gzip compression level from 1 to 9, 0 for none
+	size_t buffer_size;	// Size of the file buffer in bytes, 0 for default
+	int nosync;		// Don't flush to disk when saving, see catner_save_ext()
+};
+
+typedef struct catner_save_opts catner_save_opts_s;
+
+struct catner_variant_rec
+{
+	const char *vid;	// Variant ID (SUPPLIER_AID_SUPPLEMENT)
+	const char *value;	// Variant value
+};
+
+typedef struct catner_variant_rec catner_variant_rec_s;
+
+struct catner_feature_rec
+{
+	const char *fid;	// Feature ID
+	const char *name;	// Feature name, or NULL
+	const char *descr;	// Feature description, or NULL
+	const char *unit;	// Feature unit, or NULL
+	const char *value;	// Feature value, or NULL
+	const catner_variant_rec_s *variants;	// Variants of this feature
+	size_t num_variants;			// Number of variants
+};
+
+typedef struct catner_feature_rec catner_feature_rec_s;
+
+struct catner_unit_rec
+{
+	const char *code;	// Unit code, or NULL for the default
+	const char *factor;	// Unit factor, or NULL for the default
+	int main;		// Make this the main unit
+};
+
+typedef struct catner_unit_rec catner_unit_rec_s;
+
+struct catner_image_rec
+{
+	const char *mime;	// MIME type of the image
+	const char *path;	// Path of the image
+};
+
+typedef struct catner_image_rec catner_image_rec_s;
+
+struct catner_article_rec
+{
+	const char *aid;	// Article ID (SUPPLIER_AID)
+	const char *title;	// Article title, or NULL
+	const char *descr;	// Article description, or NULL
+	const catner_feature_rec_s *features;	// Features of this article
+	size_t num_features;			// Number of features
+	const catner_unit_rec_s *units;		// Units of this article
+	size_t num_units;			// Number of units
+	const catner_image_rec_s *images;	// Images of this article
+	size_t num_images;			// Number of images
+	const char **categories;		// Category IDs of this article
+	size_t num_categories;			// Number of categories
+};
+
+typedef struct catner_article_rec catner_article_rec_s;
+
+struct catner_str
+{
+	const char *ptr;	// Start of the string, not necessarily null-terminated
+	size_t len;		// Length of the string in bytes
+};
+
+typedef struct catner_str catner_str_s;
+
+struct catner_unit_view
+{
+	catner_str_s code;	// Unit code (ALTERNATIVE_UNIT_CODE)
+	catner_str_s factor;	// Unit factor (ALTERNATIVE_UNIT_FACTOR)
+};
+
+typedef struct catner_unit_view catner_unit_view_s;
+
+struct catner_image_view
+{
+	catner_str_s mime;	// MIME type (MIME_TYPE)
+	catner_str_s path;	// Path (MIME_SOURCE)
+};
+
+typedef struct catner_image_view catner_image_view_s;
+
+struct catner_iter
+{
+	xmlNodePtr node;	// Current element, NULL once done
+	xmlNodePtr end;		// Element the range ends before, NULL for no limit
+};
+
+typedef struct catner_iter catner_iter_s;
+
+typedef int (*catner_aid_filter)(const char *aid, void *data);
+typedef int (*catner_write_func)(void *ctx, const char *buf, int len);
+typedef int (*catner_close_func)(void *ctx);
+
 /*
  * Validating, fixing
  */
@@ -138,6 +260,7 @@ int catner_add_feature(catner_state_s *cs, const char *aid, const char *fid, con
 int catner_add_variant(catner_state_s *cs, const char *aid, const char *fid, const char *vid, const char *value);
 int catner_add_weight_feature(catner_state_s *cs, const char *aid, const char *value);
 int catner_add_weight_variant(catner_state_s *cs, const char *aid, const char *vid, const char *value);
+size_t catner_add_articles(catner_state_s *cs, const catner_article_rec_s *recs, size_t num_recs, int *status);
 
 /*
  * Setting element content
@@ -176,6 +299,31 @@ size_t catner_get_sel_article_id(catner_state_s *cs, char *buf, size_t len);
 size_t catner_get_sel_feature_id(catner_state_s *cs, char *buf, size_t len);
 size_t catner_get_sel_variant_id(catner_state_s *cs, char *buf, size_t len);
 
+/*
+ * Viewing element content without copying
+ */
+
+int catner_view_article_aid(catner_state_s *cs, const char *aid, catner_str_s *view);
+int catner_view_article_title(catner_state_s *cs, const char *aid, catner_str_s *view);
+int catner_view_article_descr(catner_state_s *cs, const char *aid, catner_str_s *view);
+int catner_view_article_unit(catner_state_s *cs, const char *aid, catner_str_s *view);
+int catner_view_feature_id(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view);
+int catner_view_feature_name(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view);
+int catner_view_feature_descr(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view);
+int catner_view_feature_unit(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view);
+int catner_view_feature_value(catner_state_s *cs, const char *aid, const char *fid, catner_str_s *view);
+int catner_view_variant_id(catner_state_s *cs, const char *aid, const char *fid, const char *vid, catner_str_s *view);
+int catner_view_variant_value(catner_state_s *cs, const char *aid, const char *fid, const char *vid, catner_str_s *view);
+int catner_view_sel_image_mime(catner_state_s *cs, catner_str_s *view);
+int catner_view_sel_image_path(catner_state_s *cs, catner_str_s *view);
+int catner_view_sel_unit_code(catner_state_s *cs, catner_str_s *view);
+int catner_view_sel_unit_factor(catner_state_s *cs, catner_str_s *view);
+
+size_t catner_view_territories(catner_state_s *cs, catner_str_s *views, size_t len);
+size_t catner_view_article_categories(catner_state_s *cs, const char *aid, catner_str_s *views, size_t len);
+size_t catner_view_article_units(catner_state_s *cs, const char *aid, catner_unit_view_s *views, size_t len);
+size_t catner_view_article_images(catner_state_s *cs, const char *aid, catner_image_view_s *views, size_t len);
+
 /*
  * Deleting elements
  */
@@ -184,6 +332,8 @@ int catner_del_generator(catner_state_s *cs);
 int catner_del_territory(catner_state_s *cs, const char *value);
 
 int catner_del_article(catner_state_s *cs, const char *aid);
+size_t catner_del_articles(catner_state_s *cs, const char **aids, size_t num_aids);
+size_t catner_del_articles_if(catner_state_s *cs, catner_aid_filter filter, void *data);
 int catner_del_article_image(catner_state_s *cs, const char *aid, const char *path);
 int catner_del_article_category(catner_state_s *cs, const char *aid, const char *cid);
 int catner_del_feature(catner_state_s *cs, const char *aid, const char *fid);
@@ -234,20 +384,67 @@ int catner_sel_next_variant(catner_state_s *cs);
 int catner_sel_next_image(catner_state_s *cs);
 int catner_sel_next_unit(catner_state_s *cs);
 
+/*
+ * Iterating elements, independent of the selection
+ */
+
+int catner_iter_articles(catner_state_s *cs, catner_iter_s *it);
+int catner_iter_features(const catner_iter_s *article, catner_iter_s *it);
+int catner_iter_variants(const catner_iter_s *feature, catner_iter_s *it);
+int catner_iter_images(const catner_iter_s *article, catner_iter_s *it);
+int catner_iter_units(const catner_iter_s *article, catner_iter_s *it);
+int catner_iter_next(catner_iter_s *it);
+size_t catner_iter_split(const catner_iter_s *it, catner_iter_s *ranges, size_t num);
+
+int catner_iter_article_aid(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_article_title(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_article_descr(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_article_unit(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_feature_id(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_feature_name(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_feature_descr(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_feature_unit(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_feature_value(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_variant_id(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_variant_value(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_image_mime(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_image_path(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_unit_code(const catner_iter_s *it, catner_str_s *view);
+int catner_iter_unit_factor(const catner_iter_s *it, catner_str_s *view);
+
 /*
  * Output
  */
 
 int catner_write_xml(catner_state_s *cs, const char *path);
+int catner_write_xml_ext(catner_state_s *cs, const char *path, const catner_save_opts_s *opts);
+int catner_write_xml_cb(catner_state_s *cs, catner_write_func on_write, catner_close_func on_close, void *ctx, const catner_save_opts_s *opts);
+int catner_write_xml_mem(catner_state_s *cs, char **buf, size_t *len, const catner_save_opts_s *opts);
+int catner_write_xml_parallel(catner_state_s *cs, const char *path, int threads);
+int catner_write_xml_split(catner_state_s *cs, const char *pattern, size_t max_articles, size_t max_bytes, int threads);
 int catner_print_xml(catner_state_s *cs);
 int catner_save(catner_state_s *cs);
+int catner_save_ext(catner_state_s *cs, const catner_save_opts_s *opts);
+int catner_is_dirty(catner_state_s *cs);
 
 /*
  * Initialization
  */
 
 catner_state_s *catner_init();
+catner_state_s *catner_init_stream(const char *path);
+int catner_stream_end(catner_state_s *cs);
 catner_state_s *catner_load(const char *path, int amend);
+catner_state_s *catner_load_ext(const char *path, int amend, const catner_load_opts_s *opts);
+catner_state_s *catner_load_parallel(const char *path, int amend, int threads, const catner_load_opts_s *opts);
+catner_state_s *catner_load_mmap(const char *path, int amend);
+catner_state_s *catner_load_memory(const char *buf, size_t len, int amend);
+catner_state_s *catner_load_fd(int fd, int amend);
+catner_state_s *catner_load_stream(const char *path);
+int catner_stream_next(catner_state_s *cs);
+catner_state_s *catner_load_filter(const char *path, catner_aid_filter filter, void *data);
+catner_state_s *catner_load_aids(const char *path, const char **aids, size_t num_aids);
+catner_state_s *catner_peek(const char *path, size_t *num_articles);
 
 /*
  * Free, Debug, etc